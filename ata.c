@@ -0,0 +1,278 @@
+// ata.c - PIIX IDE sürücüsü: PIO ve bus-master DMA, IRQ ile tamamlanma
+#include "headers.h"
+
+// PRD tablosu 4 byte hizalı olmalı ve 64 KB sınırını geçmemeli
+static ata_prd_t prdt[ATA_SG_MAX] __attribute__((aligned(64)));
+
+static uint16_t bm_base = 0;            // Bus-master I/O tabanı (BAR4)
+static int dma_enabled = 0;
+static int drive_present = 0;
+static uint32_t drive_sectors = 0;
+static char drive_model[41];
+
+static volatile uint32_t irq_done = 0;
+static volatile uint8_t irq_status = 0;
+static volatile int irq_waiter = -1;    // IRQ'yu uyuyarak bekleyen task
+static mutex_t ata_lock;
+
+static void insw(uint16_t port, void* buf, uint32_t count) {
+    asm volatile("cld; rep insw" : "+D"(buf), "+c"(count) : "d"(port) : "memory");
+}
+
+static void outsw(uint16_t port, const void* buf, uint32_t count) {
+    asm volatile("cld; rep outsw" : "+S"(buf), "+c"(count) : "d"(port) : "memory");
+}
+
+// Alternatif status okuması ~100 ns sürer; 4 okuma = 400 ns bekleme
+static void ata_delay() {
+    for(int i = 0; i < 4; i++)
+        inb(ATA_CTRL);
+}
+
+// Yoklamalı bekleme (yalnızca IDENTIFY sırasında, kesmeler kapalıyken)
+static int ata_poll(int want_drq) {
+    for(uint32_t i = 0; i < ATA_TIMEOUT; i++) {
+        uint8_t status = inb(ATA_IO + ATA_REG_STATUS);
+        if(status & ATA_SR_BSY)
+            continue;
+        if(status & (ATA_SR_ERR | ATA_SR_DF))
+            return -1;
+        if(!want_drq || (status & ATA_SR_DRQ))
+            return 0;
+    }
+    return -1;
+}
+
+static void ata_irq(regs_t* regs) {
+    (void)regs;
+    // Status okuması aygıtın kesmesini temizler
+    irq_status = inb(ATA_IO + ATA_REG_STATUS);
+    // Yalnızca IRQ biti temizlenir; ERR de write-1-to-clear, ata_dma onu görmeli
+    if(bm_base)
+        outb(bm_base + ATA_BM_STATUS, (inb(bm_base + ATA_BM_STATUS) & ~ATA_BM_SR_ERR) | ATA_BM_SR_IRQ);
+    irq_done = 1;
+
+    // irq_done yazımı irq_waiter okumasından önce görünür olmalı (store -> load)
+    asm volatile("lock orl $0, (%%esp)" : : : "memory", "cc");
+    int waiter = irq_waiter;
+    if(waiter >= 0)
+        task_wake(waiter);
+}
+
+// Önceki komuttan kalan IRQ yeni beklemeyi karşılamasın: bayrak komut yazılmadan
+// hemen önce sıfırlanır (ata_wait_irq de tükettiği IRQ'yu sıfırlar)
+static void ata_command(uint8_t cmd) {
+    irq_done = 0;
+    outb(ATA_IO + ATA_REG_COMMAND, cmd);
+}
+
+static int irq_result() {
+    irq_done = 0;
+    return (irq_status & (ATA_SR_ERR | ATA_SR_DF)) ? -1 : 0;
+}
+
+// Tamamlanmayı aygıttan yokla: IRQ14 BSP'ye gider, kesmeler kapalıyken
+// irq_done hiç gelmeyebilir. Alternatif status okuması aygıt kesmesini temizlemez.
+static int ata_poll_done(int dma) {
+    ata_delay();
+    for(uint32_t i = 0; i < ATA_TIMEOUT; i++) {
+        // IRQ başka bir CPU'da işlendiyse status orada okundu
+        if(irq_done)
+            return irq_result();
+
+        if(!(inb(ATA_CTRL) & ATA_SR_BSY) &&
+           (!dma || (inb(bm_base + ATA_BM_STATUS) & ATA_BM_SR_IRQ))) {
+            irq_status = inb(ATA_IO + ATA_REG_STATUS);
+            if(dma)
+                outb(bm_base + ATA_BM_STATUS, (inb(bm_base + ATA_BM_STATUS) & ~ATA_BM_SR_ERR) | ATA_BM_SR_IRQ);
+            return irq_result();
+        }
+        asm volatile("pause");
+    }
+    return -1;
+}
+
+// Tamamlanma IRQ'sunu bekle. Task'lar uyur, ata_irq uyandırır; idle context
+// ve kesmeleri kapalı çağıranlar aygıtı yoklar.
+static int ata_wait_irq(int dma) {
+    task_t* task = get_current_task();
+    uint32_t flags;
+    asm volatile("pushf; pop %0" : "=r"(flags));
+
+    if(task != NULL && (flags & 0x200)) {
+        while(!irq_done) {
+            irq_waiter = task->id;
+            task_prepare_block();
+            if(irq_done)
+                task_cancel_block();
+            else
+                schedule();
+        }
+        irq_waiter = -1;
+        return irq_result();
+    }
+
+    return ata_poll_done(dma);
+}
+
+static void ata_select(uint32_t lba, uint32_t sectors) {
+    outb(ATA_IO + ATA_REG_DRIVE, 0xE0 | ((lba >> 24) & 0x0F));
+    ata_delay();
+    outb(ATA_IO + ATA_REG_SECCOUNT, sectors & 0xFF);
+    outb(ATA_IO + ATA_REG_LBA0, lba & 0xFF);
+    outb(ATA_IO + ATA_REG_LBA1, (lba >> 8) & 0xFF);
+    outb(ATA_IO + ATA_REG_LBA2, (lba >> 16) & 0xFF);
+}
+
+// Her tampon buf_sectors sektör; PIO'da sektör başına bir IRQ gelir
+static int ata_pio(uint32_t lba, void* const* bufs, int nbufs, uint32_t buf_sectors, int write) {
+    uint32_t total = nbufs * buf_sectors;
+    ata_select(lba, total);
+    ata_command(write ? ATA_CMD_WRITE_PIO : ATA_CMD_READ_PIO);
+
+    for(uint32_t s = 0; s < total; s++) {
+        uint8_t* sector = (uint8_t*)bufs[s / buf_sectors] + (s % buf_sectors) * ATA_SECTOR_SIZE;
+        if(write) {
+            if(ata_poll(1) != 0)
+                return -1;
+            outsw(ATA_IO + ATA_REG_DATA, sector, ATA_SECTOR_SIZE / 2);
+            if(ata_wait_irq(0) != 0)
+                return -1;
+        } else {
+            if(ata_wait_irq(0) != 0)
+                return -1;
+            insw(ATA_IO + ATA_REG_DATA, sector, ATA_SECTOR_SIZE / 2);
+        }
+    }
+
+    if(write) {
+        ata_command(ATA_CMD_FLUSH);
+        return ata_wait_irq(0);
+    }
+    return 0;
+}
+
+// Tek komut, tampon başına bir PRD girişi (scatter-gather)
+static int ata_dma(uint32_t lba, void* const* bufs, int nbufs, uint32_t buf_sectors, int write) {
+    for(int i = 0; i < nbufs; i++) {
+        prdt[i].phys = virt_to_phys((uint32_t)bufs[i]);
+        prdt[i].bytes = buf_sectors * ATA_SECTOR_SIZE;
+        prdt[i].flags = (i == nbufs - 1) ? ATA_PRD_EOT : 0;
+    }
+
+    outb(bm_base + ATA_BM_COMMAND, 0);
+    outl(bm_base + ATA_BM_PRDT, virt_to_phys((uint32_t)prdt));
+    outb(bm_base + ATA_BM_STATUS, inb(bm_base + ATA_BM_STATUS) | ATA_BM_SR_IRQ | ATA_BM_SR_ERR);
+    // Okumada aygıt belleğe yazar
+    outb(bm_base + ATA_BM_COMMAND, write ? 0 : ATA_BM_CMD_READ);
+
+    ata_select(lba, nbufs * buf_sectors);
+    ata_command(write ? ATA_CMD_WRITE_DMA : ATA_CMD_READ_DMA);
+    outb(bm_base + ATA_BM_COMMAND, (write ? 0 : ATA_BM_CMD_READ) | ATA_BM_CMD_START);
+
+    int result = ata_wait_irq(1);
+    outb(bm_base + ATA_BM_COMMAND, 0);
+    if(inb(bm_base + ATA_BM_STATUS) & ATA_BM_SR_ERR)
+        result = -1;
+    return result;
+}
+
+int ata_rw(uint32_t lba, void* const* bufs, int nbufs, uint32_t buf_sectors, int write) {
+    if(!drive_present || nbufs <= 0 || nbufs > ATA_SG_MAX)
+        return -1;
+    if(nbufs * buf_sectors > 256 || lba + nbufs * buf_sectors > drive_sectors)
+        return -1;
+
+    mutex_lock(&ata_lock);
+    int result;
+    if(dma_enabled) {
+        result = ata_dma(lba, bufs, nbufs, buf_sectors, write);
+        // DMA başarısızsa aynı isteği PIO ile tekrarla
+        if(result != 0)
+            result = ata_pio(lba, bufs, nbufs, buf_sectors, write);
+    } else {
+        result = ata_pio(lba, bufs, nbufs, buf_sectors, write);
+    }
+    mutex_unlock(&ata_lock);
+    return result;
+}
+
+static int ata_identify() {
+    uint16_t id[256];
+
+    outb(ATA_IO + ATA_REG_DRIVE, 0xA0);
+    ata_delay();
+    outb(ATA_IO + ATA_REG_SECCOUNT, 0);
+    outb(ATA_IO + ATA_REG_LBA0, 0);
+    outb(ATA_IO + ATA_REG_LBA1, 0);
+    outb(ATA_IO + ATA_REG_LBA2, 0);
+    outb(ATA_IO + ATA_REG_COMMAND, ATA_CMD_IDENTIFY);
+
+    if(inb(ATA_IO + ATA_REG_STATUS) == 0)
+        return -1;
+    // ATAPI veya SATA imzası: bu sürücünün işi değil
+    if(inb(ATA_IO + ATA_REG_LBA1) != 0 || inb(ATA_IO + ATA_REG_LBA2) != 0)
+        return -1;
+    if(ata_poll(1) != 0)
+        return -1;
+
+    insw(ATA_IO + ATA_REG_DATA, id, 256);
+    drive_sectors = id[60] | ((uint32_t)id[61] << 16);
+
+    // Model adı byte çiftleri ters sırada
+    for(int i = 0; i < 20; i++) {
+        drive_model[i * 2] = id[27 + i] >> 8;
+        drive_model[i * 2 + 1] = id[27 + i] & 0xFF;
+    }
+    drive_model[40] = '\0';
+    for(int i = 39; i >= 0 && drive_model[i] == ' '; i--)
+        drive_model[i] = '\0';
+
+    // DMA için ATA tarafında Multiword/UDMA desteği gerekir
+    return (id[49] & (1 << 8)) ? 1 : 0;
+}
+
+void init_ata() {
+    mutex_init(&ata_lock);
+
+    // IDENTIFY kesmesiz yoklanır
+    outb(ATA_CTRL, ATA_CTRL_NIEN);
+    int dma_capable = ata_identify();
+    if(dma_capable < 0) {
+        outb(ATA_CTRL, 0);
+        return;
+    }
+    drive_present = 1;
+
+    pci_device_t ide;
+    if(dma_capable && pci_find_class(PCI_CLASS_STORAGE, PCI_SUBCLASS_IDE, &ide) == 0 &&
+       (ide.prog_if & 0x80)) {
+        uint32_t bar4 = pci_read32(ide.bus, ide.slot, ide.func, PCI_BAR4);
+        if(bar4 & 1) {
+            bm_base = bar4 & 0xFFFC;
+            uint32_t cmd = pci_read32(ide.bus, ide.slot, ide.func, PCI_COMMAND);
+            pci_write32(ide.bus, ide.slot, ide.func, PCI_COMMAND, cmd | PCI_CMD_IO | PCI_CMD_BUS_MASTER);
+            dma_enabled = 1;
+        }
+    }
+
+    register_interrupt_handler(IRQ_BASE + ATA_IRQ, ata_irq);
+    enable_irq(ATA_IRQ);
+    outb(ATA_CTRL, 0);
+}
+
+int ata_present() {
+    return drive_present;
+}
+
+int ata_dma_enabled() {
+    return dma_enabled;
+}
+
+uint32_t ata_sectors() {
+    return drive_sectors;
+}
+
+const char* ata_model() {
+    return drive_model;
+}
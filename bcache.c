@@ -0,0 +1,265 @@
+// bcache.c - Disk blok önbelleği: LBA hash, LRU, sıralı önden okuma, geri yazma
+#include "headers.h"
+
+typedef struct {
+    uint32_t block;
+    uint8_t* data;
+    int valid;
+    int dirty;
+    int readahead;              // Önden okundu, henüz kullanılmadı
+    int hash_next;
+    int prev;                   // LRU: prev MRU tarafı
+    int next;
+} bcache_entry_t;
+
+static bcache_entry_t entries[BCACHE_BLOCKS];
+static int hash_heads[BCACHE_HASH_SIZE];
+static int lru_head = -1;       // En son kullanılan
+static int lru_tail = -1;       // Atılacak ilk aday
+static int entry_count = 0;
+static uint32_t last_block = 0xFFFFFFFF;
+static bcache_stats_t stats;
+static mutex_t bcache_lock;
+
+static uint32_t hash_block(uint32_t block) {
+    return block & (BCACHE_HASH_SIZE - 1);
+}
+
+static void lru_unlink(int idx) {
+    bcache_entry_t* e = &entries[idx];
+    if(e->prev >= 0) entries[e->prev].next = e->next;
+    else lru_head = e->next;
+    if(e->next >= 0) entries[e->next].prev = e->prev;
+    else lru_tail = e->prev;
+    e->prev = e->next = -1;
+}
+
+static void lru_push_front(int idx) {
+    bcache_entry_t* e = &entries[idx];
+    e->prev = -1;
+    e->next = lru_head;
+    if(lru_head >= 0) entries[lru_head].prev = idx;
+    lru_head = idx;
+    if(lru_tail < 0) lru_tail = idx;
+}
+
+static void lru_push_back(int idx) {
+    bcache_entry_t* e = &entries[idx];
+    e->next = -1;
+    e->prev = lru_tail;
+    if(lru_tail >= 0) entries[lru_tail].next = idx;
+    lru_tail = idx;
+    if(lru_head < 0) lru_head = idx;
+}
+
+static int hash_lookup(uint32_t block) {
+    for(int i = hash_heads[hash_block(block)]; i >= 0; i = entries[i].hash_next) {
+        if(entries[i].block == block)
+            return i;
+    }
+    return -1;
+}
+
+static void hash_insert(int idx) {
+    uint32_t h = hash_block(entries[idx].block);
+    entries[idx].hash_next = hash_heads[h];
+    hash_heads[h] = idx;
+}
+
+static void hash_remove(int idx) {
+    int* link = &hash_heads[hash_block(entries[idx].block)];
+    while(*link >= 0) {
+        if(*link == idx) {
+            *link = entries[idx].hash_next;
+            return;
+        }
+        link = &entries[*link].hash_next;
+    }
+}
+
+// Ardışık bloklar tek ATA komutu (PRD başına bir blok) ile aktarılır
+static int bcache_io(uint32_t block, const int* idx, int count, int write) {
+    void* bufs[ATA_SG_MAX];
+    for(int i = 0; i < count; i++)
+        bufs[i] = entries[idx[i]].data;
+
+    uint64_t start = rdtsc();
+    int result = ata_rw(block * BCACHE_BLOCK_SECTORS, bufs, count, BCACHE_BLOCK_SECTORS, write);
+    stats.io_cycles += rdtsc() - start;
+
+    if(result == 0) {
+        if(write)
+            stats.bytes_written += (uint64_t)count * BCACHE_BLOCK_SIZE;
+        else
+            stats.bytes_read += (uint64_t)count * BCACHE_BLOCK_SIZE;
+    }
+    return result;
+}
+
+static int writeback(int idx) {
+    if(bcache_io(entries[idx].block, &idx, 1, 1) != 0)
+        return -1;
+    entries[idx].dirty = 0;
+    stats.writebacks++;
+    return 0;
+}
+
+// LRU kuyruğundan bir giriş al; kirliyse önce diske yaz. Giriş listelerden çıkmış döner.
+static int take_victim() {
+    int idx = lru_tail;
+    if(idx < 0)
+        return -1;
+
+    if(entries[idx].valid) {
+        if(entries[idx].dirty && writeback(idx) != 0)
+            return -1;
+        hash_remove(idx);
+        entries[idx].valid = 0;
+        stats.evictions++;
+    }
+    lru_unlink(idx);
+    return idx;
+}
+
+static void install(int idx, uint32_t block, int readahead) {
+    entries[idx].block = block;
+    entries[idx].valid = 1;
+    entries[idx].dirty = 0;
+    entries[idx].readahead = readahead;
+    hash_insert(idx);
+    lru_push_front(idx);
+}
+
+// Kaçırılan bloğu oku; erişim sıralıysa arkasındaki blokları da aynı komutla getir
+static int fill(uint32_t block) {
+    int count = 1;
+    if(block == last_block + 1) {
+        uint32_t disk_blocks = ata_sectors() / BCACHE_BLOCK_SECTORS;
+        while(count < 1 + BCACHE_READAHEAD && count < ATA_SG_MAX &&
+              count < entry_count / 2 && block + count < disk_blocks &&
+              hash_lookup(block + count) < 0)
+            count++;
+    }
+
+    int idx[ATA_SG_MAX];
+    for(int i = 0; i < count; i++) {
+        idx[i] = take_victim();
+        if(idx[i] < 0) {
+            for(int j = 0; j < i; j++)
+                lru_push_back(idx[j]);
+            return -1;
+        }
+    }
+
+    if(bcache_io(block, idx, count, 0) != 0) {
+        // Boş girişler ilk aday olarak kuyruğun sonuna döner
+        for(int i = 0; i < count; i++) {
+            lru_push_back(idx[i]);
+        }
+        return -1;
+    }
+
+    // Önden okunanlar önce, istenen blok en öne
+    for(int i = count - 1; i >= 1; i--)
+        install(idx[i], block + i, 1);
+    install(idx[0], block, 0);
+    stats.readahead += count - 1;
+    return idx[0];
+}
+
+int bcache_read(uint32_t block, void* buf) {
+    if(!ata_present() || entry_count == 0)
+        return -1;
+
+    mutex_lock(&bcache_lock);
+    int idx = hash_lookup(block);
+    if(idx >= 0) {
+        stats.hits++;
+        if(entries[idx].readahead) {
+            stats.readahead_hits++;
+            entries[idx].readahead = 0;
+        }
+        lru_unlink(idx);
+        lru_push_front(idx);
+    } else {
+        stats.misses++;
+        idx = fill(block);
+        if(idx < 0) {
+            mutex_unlock(&bcache_lock);
+            return -1;
+        }
+    }
+    last_block = block;
+    memcpy(buf, entries[idx].data, BCACHE_BLOCK_SIZE);
+    mutex_unlock(&bcache_lock);
+    return 0;
+}
+
+// Tam blok yazıldığı için diskten okumaya gerek yok; sync veya atılma anında yazılır
+int bcache_write(uint32_t block, const void* buf) {
+    if(!ata_present() || entry_count == 0)
+        return -1;
+
+    mutex_lock(&bcache_lock);
+    int idx = hash_lookup(block);
+    if(idx >= 0) {
+        stats.hits++;
+        lru_unlink(idx);
+    } else {
+        stats.misses++;
+        idx = take_victim();
+        if(idx < 0) {
+            mutex_unlock(&bcache_lock);
+            return -1;
+        }
+        entries[idx].block = block;
+        entries[idx].valid = 1;
+        hash_insert(idx);
+    }
+    memcpy(entries[idx].data, buf, BCACHE_BLOCK_SIZE);
+    entries[idx].dirty = 1;
+    entries[idx].readahead = 0;
+    lru_push_front(idx);
+    mutex_unlock(&bcache_lock);
+    return 0;
+}
+
+int bcache_sync() {
+    int result = 0;
+    mutex_lock(&bcache_lock);
+    for(int i = 0; i < entry_count; i++) {
+        if(entries[i].valid && entries[i].dirty && writeback(i) != 0)
+            result = -1;
+    }
+    mutex_unlock(&bcache_lock);
+    return result;
+}
+
+void get_bcache_stats(bcache_stats_t* out) {
+    mutex_lock(&bcache_lock);
+    *out = stats;
+    mutex_unlock(&bcache_lock);
+}
+
+void init_bcache() {
+    mutex_init(&bcache_lock);
+    memset(&stats, 0, sizeof(stats));
+
+    for(int i = 0; i < BCACHE_HASH_SIZE; i++)
+        hash_heads[i] = -1;
+
+    if(!ata_present())
+        return;
+
+    for(int i = 0; i < BCACHE_BLOCKS; i++) {
+        uint8_t* page = (uint8_t*)alloc_page();
+        if(!page)
+            break;
+        entries[i].data = page;
+        entries[i].valid = 0;
+        entries[i].hash_next = -1;
+        entries[i].prev = entries[i].next = -1;
+        lru_push_front(i);
+        entry_count++;
+    }
+}
@@ -1,5 +1,14 @@
 [BITS 16]
-[ORG 0x7C00]
+[ORG 0x0800]
+
+; Makefile üretir: KERNEL_SECTORS = kernel.bin + initrd.img sektör sayısı
+%include "kernel_size.inc"
+
+BOOT_INFO       equ 0x0500      ; Kernel'a aktarılan bilgi (headers.h: boot_info_t)
+KERNEL_SEG      equ 0x0100      ; Kernel 0x0100:0000 = 0x1000'e yüklenir
+LBA_MAX_CHUNK   equ 127         ; Çoğu BIOS'un tek paketle kabul ettiği üst sınır
+FLOPPY_SPT      equ 18
+FLOPPY_HEADS    equ 2
 
 start:
     cli                     ; Interrupt'ları kapat
@@ -8,7 +17,24 @@ start:
     mov es, ax
     mov ss, ax
     mov sp, 0x7C00          ; Stack pointer ayarla
+    cld
+
+    ; Firmware süresi: reset'ten buraya kadar geçen TSC
+    rdtsc
+    mov [BOOT_INFO], eax
+    mov [BOOT_INFO + 4], edx
+
+    ; Büyük kernel 0x7C00'ü ezer: boot sektörünü 0x0800'e taşı
+    mov si, 0x7C00
+    mov di, 0x0800
+    mov cx, 256
+    rep movsw
+    jmp 0x0000:relocated
+
+relocated:
+    mov sp, 0x1000          ; Stack boot sektörü ile kernel arasında
     sti                     ; Interrupt'ları aç
+    mov [boot_drive], dl
 
     ; Ekranı temizle
     mov ah, 0x00
@@ -19,15 +45,112 @@ start:
     mov si, msg_boot
     call print_string
 
-    ; Disk'ten kernel'ı yükle (1. sektörden sonra)
-    mov ah, 0x02            ; Read sectors
-    mov al, 15              ; 15 sektör oku (kernel için)
-    mov ch, 0               ; Cylinder 0
-    mov cl, 2               ; Sector 2'den başla
-    mov dh, 0               ; Head 0
-    mov bx, 0x1000          ; ES:BX = 0x0000:0x1000
+    mov word [BOOT_INFO + 16], KERNEL_SECTORS
+
+    ; INT 13h uzantıları (paket erişimi) var mı?
+    mov ah, 0x41
+    mov bx, 0x55AA
+    mov dl, [boot_drive]
+    int 0x13
+    jc load_chs
+    cmp bx, 0xAA55
+    jne load_chs
+    test cl, 1
+    jz load_chs
+
+    mov byte [BOOT_INFO + 18], 1    ; Yöntem: LBA
+
+; BIOS'un kabul ettiği en büyük parçalarla LBA okuma
+load_lba:
+    mov cx, [sectors_left]
+    test cx, cx
+    jz load_done
+    cmp cx, [chunk]
+    jbe .count_ok
+    mov cx, [chunk]
+.count_ok:
+    mov [dap_count], cx
+    mov si, dap
+    mov ah, 0x42
+    mov dl, [boot_drive]
+    int 0x13
+    jc .shrink
+
+    mov cx, [dap_count]
+    mov [BOOT_INFO + 20], cx        ; Son başarılı parça boyutu
+    call advance
+    jmp load_lba
+
+.shrink:
+    ; Parça reddedildi: diski sıfırla, yarıya indir; 1'de de olmuyorsa CHS
+    call reset_disk
+    shr word [chunk], 1
+    jnz load_lba
+
+; Track track CHS okuma (LBA yoksa veya başarısızsa kalan kısım için).
+; Image 1.44 MB disket olarak üretildiği için geometri 18 sektör / 2 kafa.
+load_chs:
+    mov byte [BOOT_INFO + 18], 2    ; Yöntem: CHS
+
+chs_loop:
+    mov cx, [sectors_left]
+    test cx, cx
+    jz load_done
+
+    ; LBA -> sektör / kafa / silindir
+    mov ax, [dap_lba]
+    xor dx, dx
+    mov bx, FLOPPY_SPT
+    div bx
+    mov [sector], dl
+    xor dx, dx
+    mov bl, FLOPPY_HEADS
+    div bx                          ; ax = silindir, dx = kafa
+
+    ; Track'in kalanı kadar (tek sektör modunda 1)
+    mov bl, FLOPPY_SPT
+    sub bl, [sector]
+    cmp byte [chs_single], 0
+    je .limit
+    mov bx, 1
+.limit:
+    cmp bx, cx
+    jbe .count_ok
+    mov bx, cx
+.count_ok:
+    mov [chs_count], bl
+
+    mov ch, al
+    shl ah, 6
+    mov cl, [sector]
+    inc cl
+    or cl, ah
+    mov dh, dl
+    mov dl, [boot_drive]
+    mov bx, [dap_segment]
+    mov es, bx
+    xor bx, bx
+    mov ah, 0x02
+    mov al, [chs_count]
     int 0x13
-    jc disk_error
+    jc .error
+
+    movzx cx, byte [chs_count]
+    call advance
+    jmp chs_loop
+
+.error:
+    ; Çok sektörlü okuma DMA sınırına takılmış olabilir: tek tek dene
+    call reset_disk
+    cmp byte [chs_single], 0
+    jne disk_error
+    mov byte [chs_single], 1
+    jmp chs_loop
+
+load_done:
+    rdtsc
+    mov [BOOT_INFO + 8], eax
+    mov [BOOT_INFO + 12], edx
 
     ; Protected mode'a geç
     call enable_a20
@@ -40,6 +163,20 @@ start:
 
     jmp 0x08:protected_mode
 
+; cx sektör okundu: sayaçları ilerlet (DAP alanları iki yöntemin de konumudur)
+advance:
+    sub [sectors_left], cx
+    add [dap_lba], cx
+    shl cx, 5                       ; sektör * 512 / 16 = paragraf
+    add [dap_segment], cx
+    ret
+
+reset_disk:
+    xor ah, ah
+    mov dl, [boot_drive]
+    int 0x13
+    ret
+
 disk_error:
     mov si, msg_disk_error
     call print_string
@@ -64,9 +201,29 @@ print_string:
 msg_boot db 'DivineOS v1.0 Booting...', 0x0D, 0x0A, 0
 msg_disk_error db 'Disk Read Error!', 0x0D, 0x0A, 0
 
+; Yükleme durumu
+boot_drive db 0
+sector db 0
+chs_count db 0
+chs_single db 0
+sectors_left dw KERNEL_SECTORS
+chunk dw LBA_MAX_CHUNK
+
+; INT 13h AH=42h disk adres paketi; hedef ve LBA her okumada ilerletilir
+dap:
+    db 0x10, 0
+dap_count dw 0
+    dw 0                    ; Offset
+dap_segment dw KERNEL_SEG
+dap_lba dd 1, 0
+
 ; GDT (Global Descriptor Table)
+; Null descriptor kullanılmaz, GDTR onun yerine saklanır
 gdt_start:
-    dq 0x0000000000000000   ; Null descriptor
+gdt_descriptor:
+    dw gdt_end - gdt_start - 1
+    dd gdt_start
+    dw 0
 
 gdt_code:
     dw 0xFFFF               ; Limit
@@ -86,10 +243,6 @@ gdt_data:
 
 gdt_end:
 
-gdt_descriptor:
-    dw gdt_end - gdt_start - 1
-    dd gdt_start
-
 [BITS 32]
 protected_mode:
     mov ax, 0x10
@@ -104,4 +257,4 @@ protected_mode:
     jmp 0x1000
 
 times 510-($-$$) db 0
-dw 0xAA55
\ No newline at end of file
+dw 0xAA55
@@ -0,0 +1,92 @@
+// gdt.c - Kernel GDT, user segmentleri ve CPU başına TSS
+#include "headers.h"
+
+typedef struct {
+    uint16_t limit_low;
+    uint16_t base_low;
+    uint8_t base_mid;
+    uint8_t access;
+    uint8_t granularity;
+    uint8_t base_high;
+} __attribute__((packed)) gdt_entry_t;
+
+typedef struct {
+    uint16_t limit;
+    uint32_t base;
+} __attribute__((packed)) gdt_ptr_t;
+
+// Yalnızca ring 3 -> ring 0 geçişinde ss0:esp0 kullanılır
+typedef struct {
+    uint32_t prev_tss;
+    uint32_t esp0;
+    uint32_t ss0;
+    uint32_t esp1, ss1, esp2, ss2;
+    uint32_t cr3, eip, eflags;
+    uint32_t eax, ecx, edx, ebx, esp, ebp, esi, edi;
+    uint32_t es, cs, ss, ds, fs, gs;
+    uint32_t ldt;
+    uint16_t trap;
+    uint16_t iomap_base;
+} __attribute__((packed, aligned(4))) tss_t;
+
+static gdt_entry_t gdt[GDT_ENTRIES];
+static gdt_ptr_t gdt_ptr;
+static tss_t tss[MAX_CPUS];
+
+static void set_gdt_entry(int i, uint32_t base, uint32_t limit, uint8_t access, uint8_t gran) {
+    gdt[i].base_low = base & 0xFFFF;
+    gdt[i].base_mid = (base >> 16) & 0xFF;
+    gdt[i].base_high = (base >> 24) & 0xFF;
+    gdt[i].limit_low = limit & 0xFFFF;
+    gdt[i].granularity = ((limit >> 16) & 0x0F) | (gran & 0xF0);
+    gdt[i].access = access;
+}
+
+// GDT'yi yükle ve segment register'larını yenile (AP'ler de çağırır)
+void load_gdt() {
+    asm volatile("lgdt %0\n"
+                 "ljmp %1, $1f\n"
+                 "1:\n"
+                 "mov %2, %%ax\n"
+                 "mov %%ax, %%ds\n"
+                 "mov %%ax, %%es\n"
+                 "mov %%ax, %%fs\n"
+                 "mov %%ax, %%gs\n"
+                 "mov %%ax, %%ss\n"
+                 : : "m"(gdt_ptr), "i"(KERNEL_CS), "i"(KERNEL_DS) : "eax", "memory");
+}
+
+// Her CPU kendi TSS'ini yükler; ltr descriptor'ı busy işaretler
+void load_tss(int cpu) {
+    uint16_t sel = TSS_SELECTOR(cpu);
+    asm volatile("ltr %0" : : "r"(sel));
+}
+
+// Ring 3'ten gelen kesme ve SYSENTER bu stack'e iner
+void tss_set_kernel_stack(int cpu, uint32_t esp0) {
+    tss[cpu].esp0 = esp0;
+}
+
+uint32_t* tss_esp0_ptr(int cpu) {
+    return &tss[cpu].esp0;
+}
+
+void init_gdt() {
+    set_gdt_entry(0, 0, 0, 0, 0);                   // Null
+    set_gdt_entry(1, 0, 0xFFFFFFFF, 0x9A, 0xCF);    // Kernel code
+    set_gdt_entry(2, 0, 0xFFFFFFFF, 0x92, 0xCF);    // Kernel data
+    set_gdt_entry(3, 0, 0xFFFFFFFF, 0xFA, 0xCF);    // User code (DPL 3)
+    set_gdt_entry(4, 0, 0xFFFFFFFF, 0xF2, 0xCF);    // User data (DPL 3)
+
+    // I/O izin bitmap'i yok: iomap_base limitin dışında, ring 3 port erişemez
+    memset(tss, 0, sizeof(tss));
+    for(int i = 0; i < MAX_CPUS; i++) {
+        tss[i].ss0 = KERNEL_DS;
+        tss[i].iomap_base = sizeof(tss_t);
+        set_gdt_entry(GDT_TSS_BASE + i, (uint32_t)&tss[i], sizeof(tss_t) - 1, 0x89, 0x00);
+    }
+
+    gdt_ptr.limit = sizeof(gdt) - 1;
+    gdt_ptr.base = (uint32_t)&gdt;
+    load_gdt();
+}
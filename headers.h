@@ -22,12 +22,90 @@ typedef unsigned int size_t;
 // ============================================
 uint8_t inb(uint16_t port);
 void outb(uint16_t port, uint8_t val);
+uint16_t inw(uint16_t port);
+void outw(uint16_t port, uint16_t val);
+uint32_t inl(uint16_t port);
+void outl(uint16_t port, uint32_t val);
+
+// ============================================
+// CPU Yardımcıları
+// ============================================
+#define CPUID_EDX_PSE (1 << 3)
+#define CPUID_EDX_SEP (1 << 11)
+#define CPUID_EDX_MSR (1 << 5)
+#define CPUID_EDX_APIC (1 << 9)
+#define CPUID_EDX_PGE (1 << 13)
+#define CPUID_EDX_PAT (1 << 16)
+#define CPUID_EDX_SSE2 (1 << 26)
+
+void cpuid(uint32_t leaf, uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx);
+uint64_t rdmsr(uint32_t msr);
+void wrmsr(uint32_t msr, uint64_t val);
+uint64_t rdtsc();
+void pit_delay_us(uint32_t us);
+
+// ============================================
+// Açılış Bilgisi (boot.asm doldurur)
+// ============================================
+#define BOOT_INFO_ADDR 0x0500
+#define BOOT_METHOD_LBA 1
+#define BOOT_METHOD_CHS 2
+
+typedef struct {
+    uint64_t tsc_entry;         // Boot sektörüne girişte (firmware süresi)
+    uint64_t tsc_loaded;        // Kernel yüklendiğinde
+    uint16_t kernel_sectors;
+    uint8_t load_method;
+    uint8_t reserved;
+    uint16_t last_chunk;        // Son başarılı LBA okumasının sektör sayısı
+} __attribute__((packed)) boot_info_t;
+
+// ============================================
+// GDT / IDT / Kesmeler
+// ============================================
+// Null, kernel code/data, user code/data, CPU başına bir TSS.
+// SYSENTER/SYSEXIT bu sırayı ister: KERNEL_CS + 8/16/24 = KERNEL_DS/USER_CS/USER_DS
+#define GDT_TSS_BASE 5
+#define GDT_ENTRIES (GDT_TSS_BASE + MAX_CPUS)
+#define KERNEL_CS 0x08
+#define KERNEL_DS 0x10
+#define USER_CS 0x18
+#define USER_DS 0x20
+#define TSS_SELECTOR(cpu) ((GDT_TSS_BASE + (cpu)) * 8)
+
+#define IRQ_BASE 0x20
+#define SPURIOUS_VECTOR 0xFF
+#define IDT_GATE_INT 0x8E       // Present, DPL 0, 32-bit interrupt gate
+#define IDT_GATE_USER 0xEE      // Present, DPL 3: ring 3'ten int ile çağrılabilir
+
+typedef struct {
+    uint32_t gs, fs, es, ds;
+    uint32_t edi, esi, ebp, esp, ebx, edx, ecx, eax;
+    uint32_t int_no, err_code;
+    uint32_t eip, cs, eflags, useresp, ss;
+} regs_t;
+
+typedef void (*interrupt_handler_t)(regs_t* regs);
+
+void init_gdt();
+void load_gdt();
+void load_tss(int cpu);
+void tss_set_kernel_stack(int cpu, uint32_t esp0);
+uint32_t* tss_esp0_ptr(int cpu);
+void init_idt();
+void load_idt();
+void set_idt_gate(uint8_t vector, uint32_t handler, uint8_t flags);
+void register_interrupt_handler(uint8_t vector, interrupt_handler_t handler);
+void enable_irq(uint8_t irq);
+void switch_to_ioapic();
+void irq_eoi(uint8_t vector);
 
 // ============================================
 // String Fonksiyonları
 // ============================================
 int strlen(const char* str);
 int strcmp(const char* s1, const char* s2);
+int strncmp(const char* s1, const char* s2, size_t n);
 void* memset(void* dest, int val, size_t len);
 void* memcpy(void* dest, const void* src, size_t len);
 
@@ -74,6 +152,25 @@ void kprint_backspace();
 void set_color(uint8_t fg, uint8_t bg);
 void plot_pixel(int x, int y, uint8_t color);
 
+// ============================================
+// Render Hattı
+// ============================================
+#define RENDER_WIDTH 320
+#define RENDER_HEIGHT 200
+#define RENDER_TILE_W 32
+#define RENDER_TILE_H 20
+#define RENDER_TILES_X (RENDER_WIDTH / RENDER_TILE_W)
+#define RENDER_TILES ((RENDER_WIDTH / RENDER_TILE_W) * (RENDER_HEIGHT / RENDER_TILE_H))
+#define RENDER_MAX_WORKERS 8
+
+// [x0, x1) x [y0, y1) bölgesini 320 byte satırlı tampona çizer
+typedef void (*render_tile_fn)(int x0, int y0, int x1, int y1, uint8_t* fb);
+
+void init_render();
+int render_submit(render_tile_fn shader);
+int render_busy();
+void render_stats();
+
 // ============================================
 // Keyboard
 // ============================================
@@ -91,22 +188,146 @@ void keyboard_handler();
 #define HEAP_SIZE 0x100000
 #define BLOCK_SIZE 4096
 
+// İstatistik ayarları
+#define HEAP_HIST_BUCKETS 21    // log2 boyut kovaları (1 B .. 1 MB)
+#define HEAP_TRACK_CALLERS 1    // Çağrı noktası başına canlı byte takibi
+#define HEAP_MAX_SITES 16
+#define HEAP_SITE_OTHER 0xFFFFFFFF  // Tablo dolunca kullanılan son slotun caller'ı
+
+// Sayfa havuzu (heap'in hemen arkası, identity map içinde)
+#define PAGE_POOL_START (HEAP_START + HEAP_SIZE)
+#define PAGE_POOL_PAGES 512
+#define ZERO_POOL_LOW 32        // Bunun altına inince arka planda sıfırlamaya başla
+#define ZERO_POOL_HIGH 128      // Bu kadar sıfırlı sayfa birikince dur
+
 typedef struct mem_block {
     uint32_t size;
     uint8_t is_free;
     struct mem_block* next;
+#if HEAP_TRACK_CALLERS
+    uint32_t caller;            // kmalloc'u çağıran adres
+#endif
 } mem_block_t;
 
+typedef struct {
+    uint32_t total;
+    uint32_t used;
+    uint32_t peak;
+    uint32_t used_blocks;
+    uint32_t free_blocks;
+    uint32_t free_bytes;
+    uint32_t largest_free;
+    uint32_t fragmentation;     // Dış parçalanma yüzdesi
+    uint32_t alloc_count;
+    uint32_t free_count;
+    uint32_t failed_count;
+    uint32_t histogram[HEAP_HIST_BUCKETS];
+    uint32_t free_pages;
+    uint32_t zeroed_pages;
+} heap_stats_t;
+
+typedef struct {
+    uint32_t caller;
+    uint32_t live_bytes;
+    uint32_t allocs;
+} heap_site_t;
+
 void init_memory();
 void* kmalloc(uint32_t size);
+void* kzalloc(uint32_t size);
 void kfree(void* ptr);
+void* alloc_page();
+void* alloc_zeroed_page();
+void free_page(void* page);
+int zero_idle_page();
 uint32_t get_total_memory();
 uint32_t get_used_memory();
+void get_heap_stats(heap_stats_t* stats);
+#if HEAP_TRACK_CALLERS
+const heap_site_t* get_heap_sites();
+#endif
+
+// ============================================
+// VFS (initrd)
+// ============================================
+#define VFS_MAX_FILES 64
+#define VFS_HASH_SIZE 64
+#define VFS_MAX_OPEN 16
+#define INITRD_MAX_SIZE 0x60000     // Kernel sonu ile boot stack'i arası
+
+#define CPIO_HEADER_SIZE 110
+#define CPIO_MODE_TYPE 0170000
+#define CPIO_MODE_FILE 0100000
+
+typedef struct {
+    const char* name;           // Arşivin içine işaret eder
+    const uint8_t* data;        // Arşivin içine işaret eder (kopyasız)
+    uint32_t size;
+    uint32_t mode;
+    uint32_t hash;
+    int next;                   // Aynı kovadaki sonraki düğüm
+} vfs_node_t;
+
+typedef struct {
+    vfs_node_t* node;           // NULL: boş slot
+    uint32_t offset;
+} vfs_file_t;
+
+typedef struct {
+    uint32_t size;
+    uint32_t mode;
+} vfs_stat_t;
+
+void init_vfs();
+int vfs_open(const char* path);
+void vfs_close(int fd);
+int vfs_read(int fd, void* buf, uint32_t len);
+const void* vfs_map(int fd, uint32_t* size);
+int vfs_stat(const char* path, vfs_stat_t* st);
+int vfs_readdir(int index, const char** name, vfs_stat_t* st);
+uint32_t vfs_initrd_size();
+
+// ============================================
+// Paging
+// ============================================
+#define PAGE_SIZE 4096
+#define LARGE_PAGE_SIZE 0x400000
+#define PAGING_IDENTITY_END 0x1000000    // İlk 16 MB identity map
+#define PAGING_MAX_TABLES 8
+
+#define VGA_WINDOW_START 0xA0000
+#define VGA_WINDOW_END 0xC0000
+
+#define PAGE_PRESENT (1 << 0)
+#define PAGE_WRITE (1 << 1)
+#define PAGE_USER (1 << 2)
+#define PAGE_PWT (1 << 3)
+#define PAGE_PCD (1 << 4)
+#define PAGE_LARGE (1 << 7)     // PDE: 4 MB sayfa
+#define PAGE_PAT (1 << 7)       // PTE: PAT indeks biti (giriş 4 = WC)
+#define PAGE_GLOBAL (1 << 8)
+
+#define CR0_PG (1u << 31)
+#define CR4_PSE (1 << 4)
+#define CR4_PGE (1 << 7)
+
+#define MSR_IA32_PAT 0x277
+#define PAT_TYPE_WC 0x01
+
+void init_paging();
+void init_paging_ap();
+void lock_mappings();
+int map_page(uint32_t virt, uint32_t phys, uint32_t flags);
+void set_user_access(uint32_t start, uint32_t end);
+int user_access_ok(uint32_t addr, uint32_t len);
+void unmap_page(uint32_t virt);
+uint32_t virt_to_phys(uint32_t virt);
 
 // ============================================
 // Task Scheduler
 // ============================================
 #define MAX_TASKS 32
+#define TASK_STACK_SIZE 4096
 
 typedef enum {
     TASK_READY,
@@ -123,12 +344,299 @@ typedef struct {
     uint32_t ebp;
     uint32_t eip;
     uint32_t priority;
+    uint32_t stack;             // kmalloc ile ayrılan stack tabanı
+    int cpu;                    // Son çalıştığı CPU
+    volatile int on_cpu;        // Stack'i hâlâ bir CPU'da kullanılıyor
+    uint32_t user_eip;          // 0: kernel task'ı
+    uint32_t user_stack;        // Ring 3 stack tabanı
+    uint32_t arg;               // Giriş fonksiyonuna verilen argüman
 } task_t;
 
 void init_scheduler();
-void create_task(void (*entry)(), const char* name, uint32_t priority);
+int create_task(void (*entry)(), const char* name, uint32_t priority);
+int create_task_arg(void (*entry)(uint32_t), const char* name, uint32_t priority, uint32_t arg);
+int create_user_task(void (*entry)(), const char* name);
 void schedule();
 void list_tasks();
 task_t* get_current_task();
+task_state_t get_task_state(int task_id);
+int tasks_pending();
+void yield();
+void task_exit();
+void task_prepare_block();
+void task_cancel_block();
+void task_wake(int task_id);
+
+// ============================================
+// IPC Kanalları
+// ============================================
+#define IPC_MAX_CHANNELS 16
+#define IPC_RING_SLOTS 16
+#define IPC_INLINE_MAX 48
+
+// Küçük mesajlar data[] içinde kopyalanır; büyük tamponlarda yalnızca
+// buf işaretçisi taşınır ve tamponun sahipliği alıcıya geçer
+typedef struct {
+    uint32_t type;
+    uint32_t len;
+    void* buf;                  // Devredilen tampon (inline mesajda NULL)
+    uint8_t data[IPC_INLINE_MAX];
+} ipc_msg_t;
+
+void init_ipc();
+int ipc_create(const char* name);
+void ipc_destroy(int ch);
+int ipc_send(int ch, uint32_t type, const void* data, uint32_t len);
+int ipc_send_buf(int ch, uint32_t type, void* buf, uint32_t len);
+int ipc_recv(int ch, ipc_msg_t* msg);
+int ipc_wait(const int* chans, int count);
+void list_channels();
+
+// ============================================
+// SMP
+// ============================================
+#define MAX_CPUS 8
+#define SMP_TRAMPOLINE 0x98000  // AP giriş kodu, boot stack'inin üstü (SIPI vektörü 0x98)
+#define AP_STACK_SIZE 4096
+#define WAKEUP_VECTOR 0xF0      // Uyuyan CPU'yu kuyruğa iş gelince uyandıran IPI
+
+#define MSR_IA32_APIC_BASE 0x1B
+#define APIC_BASE_ENABLE (1 << 11)
+
+#define LAPIC_ID 0x020
+#define LAPIC_TPR 0x080
+#define LAPIC_EOI 0x0B0
+#define LAPIC_SVR 0x0F0
+#define LAPIC_ICR_LOW 0x300
+#define LAPIC_ICR_HIGH 0x310
+#define LAPIC_SVR_ENABLE 0x100
+#define LAPIC_ICR_FIXED 0x4000
+#define LAPIC_ICR_INIT 0x4500
+#define LAPIC_ICR_STARTUP 0x4600
+#define LAPIC_ICR_PENDING (1 << 12)
+
+#define IOAPIC_VER 0x01
+#define IOAPIC_REDTBL 0x10
+#define IOAPIC_ACTIVE_LOW (1 << 13)
+#define IOAPIC_LEVEL (1 << 15)
+#define IOAPIC_MASKED (1 << 16)
+
+#define MADT_LAPIC 0
+#define MADT_IOAPIC 1
+#define MADT_ISO 2
+#define MP_PROCESSOR 0
+#define MP_IOAPIC 2
+
+typedef struct {
+    volatile uint32_t next;
+    volatile uint32_t owner;
+} spinlock_t;
+
+typedef struct {
+    int id;
+    uint32_t apic_id;
+    volatile uint32_t online;
+
+    // Run queue (halka); sahibi baştan, çalan CPU sondan alır
+    spinlock_t rq_lock;
+    int run_queue[MAX_TASKS];
+    int rq_head;
+    volatile int rq_count;
+
+    int current_task;           // -1: idle context
+    int prev_task;              // Switch sonrası kuyruğa dönecek task
+    uint32_t idle_esp;
+
+    uint32_t switches;
+    uint32_t steals;
+    volatile uint32_t idle;     // hlt'de, iş gelirse WAKEUP_VECTOR ister
+} cpu_t;
+
+uint32_t atomic_add(volatile uint32_t* ptr, uint32_t val);
+void spin_init(spinlock_t* lock);
+void spin_lock(spinlock_t* lock);
+void spin_unlock(spinlock_t* lock);
+uint32_t spin_lock_irqsave(spinlock_t* lock);
+void spin_unlock_irqrestore(spinlock_t* lock, uint32_t flags);
+
+// Uyuyan kilit: bekleyen task bloklanır, idle context kuyruğu çalıştırarak bekler.
+// G/Ç süresince tutulan kilitler için (spinlock'ta sahibi uyurken CPU yanar)
+typedef struct {
+    spinlock_t lock;
+    volatile uint32_t locked;
+    uint32_t waiters;           // Task id bit maskesi
+} mutex_t;
+
+void mutex_init(mutex_t* m);
+void mutex_lock(mutex_t* m);
+void mutex_unlock(mutex_t* m);
+
+void init_smp();
+cpu_t* this_cpu();
+cpu_t* get_cpu(int index);
+int get_cpu_count();
+void list_cpus();
+void lapic_eoi();
+void cpu_idle();
+void smp_kick_idle(cpu_t* target);
+void ioapic_route_irq(uint8_t irq, uint8_t vector);
+
+// ============================================
+// PCI
+// ============================================
+#define PCI_CONFIG_ADDRESS 0xCF8
+#define PCI_CONFIG_DATA 0xCFC
+
+#define PCI_VENDOR_ID 0x00
+#define PCI_COMMAND 0x04
+#define PCI_CLASS 0x08
+#define PCI_HEADER_TYPE 0x0C
+#define PCI_BAR4 0x20
+
+#define PCI_CMD_IO (1 << 0)
+#define PCI_CMD_BUS_MASTER (1 << 2)
+
+#define PCI_CLASS_STORAGE 0x01
+#define PCI_SUBCLASS_IDE 0x01
+
+typedef struct {
+    uint8_t bus;
+    uint8_t slot;
+    uint8_t func;
+    uint16_t vendor_id;
+    uint16_t device_id;
+    uint8_t prog_if;
+} pci_device_t;
+
+uint32_t pci_read32(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset);
+void pci_write32(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset, uint32_t val);
+int pci_find_class(uint8_t class_code, uint8_t subclass, pci_device_t* dev);
+
+// ============================================
+// ATA (PIIX IDE, birincil kanal master)
+// ============================================
+#define ATA_IO 0x1F0
+#define ATA_CTRL 0x3F6
+#define ATA_IRQ 14
+#define ATA_SECTOR_SIZE 512
+#define ATA_SG_MAX 8
+#define ATA_TIMEOUT 10000000
+
+#define ATA_REG_DATA 0
+#define ATA_REG_SECCOUNT 2
+#define ATA_REG_LBA0 3
+#define ATA_REG_LBA1 4
+#define ATA_REG_LBA2 5
+#define ATA_REG_DRIVE 6
+#define ATA_REG_COMMAND 7
+#define ATA_REG_STATUS 7
+
+#define ATA_SR_ERR 0x01
+#define ATA_SR_DRQ 0x08
+#define ATA_SR_DF 0x20
+#define ATA_SR_BSY 0x80
+#define ATA_CTRL_NIEN 0x02
+
+#define ATA_CMD_READ_PIO 0x20
+#define ATA_CMD_WRITE_PIO 0x30
+#define ATA_CMD_READ_DMA 0xC8
+#define ATA_CMD_WRITE_DMA 0xCA
+#define ATA_CMD_FLUSH 0xE7
+#define ATA_CMD_IDENTIFY 0xEC
+
+// Bus-master kayıtları (BAR4 tabanına göre)
+#define ATA_BM_COMMAND 0
+#define ATA_BM_STATUS 2
+#define ATA_BM_PRDT 4
+#define ATA_BM_CMD_START 0x01
+#define ATA_BM_CMD_READ 0x08
+#define ATA_BM_SR_ERR 0x02
+#define ATA_BM_SR_IRQ 0x04
+#define ATA_PRD_EOT 0x8000
+
+typedef struct {
+    uint32_t phys;
+    uint16_t bytes;             // 0 = 64 KB
+    uint16_t flags;
+} __attribute__((packed)) ata_prd_t;
+
+void init_ata();
+int ata_rw(uint32_t lba, void* const* bufs, int nbufs, uint32_t buf_sectors, int write);
+int ata_present();
+int ata_dma_enabled();
+uint32_t ata_sectors();
+const char* ata_model();
+
+// ============================================
+// Blok Önbelleği
+// ============================================
+#define BCACHE_BLOCK_SIZE PAGE_SIZE
+#define BCACHE_BLOCK_SECTORS (BCACHE_BLOCK_SIZE / ATA_SECTOR_SIZE)
+#define BCACHE_BLOCKS 32
+#define BCACHE_HASH_SIZE 16
+#define BCACHE_READAHEAD 4
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t readahead;         // Önden okunan blok
+    uint32_t readahead_hits;    // Önden okunup kullanılan blok
+    uint32_t writebacks;
+    uint32_t evictions;
+    uint64_t bytes_read;        // Diskten okunan
+    uint64_t bytes_written;     // Diske yazılan
+    uint64_t io_cycles;         // ata_rw içinde geçen TSC
+} bcache_stats_t;
+
+void init_bcache();
+int bcache_read(uint32_t block, void* buf);
+int bcache_write(uint32_t block, const void* buf);
+int bcache_sync();
+void get_bcache_stats(bcache_stats_t* stats);
+
+// ============================================
+// Sistem Çağrıları / Ring 3
+// ============================================
+#define SYSCALL_VECTOR 0x80
+#define MSR_IA32_SYSENTER_CS 0x174
+#define MSR_IA32_SYSENTER_ESP 0x175
+#define MSR_IA32_SYSENTER_EIP 0x176
+
+// Numara eax'te, argümanlar ebx, esi, edi'de; dönüş eax'te
+#define SYS_EXIT 0
+#define SYS_WRITE 1
+#define SYS_YIELD 2
+#define SYS_GETTID 3
+#define SYS_NOP 4
+#define SYSCALL_COUNT 5
+
+#define USER_MAX_TASKS 8
+#define USER_STACK_SIZE PAGE_SIZE
+
+// Ring 3 kodu ve verisi .user bölümünde durur; yalnızca bu bölüm
+// ve user stack'leri PAGE_USER ile eşlenir
+#define USER_TEXT __attribute__((section(".user.text")))
+#define USER_DATA __attribute__((section(".user.data")))
+
+typedef struct {
+    volatile uint32_t done;
+    uint32_t iterations;
+    uint32_t int80_cycles;      // Gidiş-dönüş, çağrı başına
+    uint32_t sysenter_cycles;
+} user_bench_t;
+
+void init_syscalls();
+void init_sysenter();
+int sysenter_enabled();
+uint32_t user_stack_alloc();
+void user_stack_free(uint32_t stack);
+void enter_user(uint32_t eip, uint32_t esp);
+void list_syscalls();
+
+// user.c: ring 3 programları
+extern uint32_t user_use_sysenter;
+extern user_bench_t user_bench_result;
+void user_bench_main();
+void user_crash_main();
 
 #endif
\ No newline at end of file
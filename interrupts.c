@@ -0,0 +1,193 @@
+// interrupts.c - IDT, 8259 PIC ve kesme dağıtımı
+#include "headers.h"
+
+typedef struct {
+    uint16_t base_low;
+    uint16_t selector;
+    uint8_t zero;
+    uint8_t flags;
+    uint16_t base_high;
+} __attribute__((packed)) idt_entry_t;
+
+typedef struct {
+    uint16_t limit;
+    uint32_t base;
+} __attribute__((packed)) idt_ptr_t;
+
+static idt_entry_t idt[256];
+static idt_ptr_t idt_ptr;
+static interrupt_handler_t handlers[256];
+static int pic_active = 1;
+static uint16_t irq_enabled_mask = 0;
+
+// Kesme giriş noktaları: hata kodu olmayanlar için sahte 0 itilir,
+// ardından vektör numarası ve ortak stub
+#define ISR_NOERR(n) ".globl isr" #n "\nisr" #n ":\n push $0\n push $" #n "\n jmp isr_common\n"
+#define ISR_ERR(n) ".globl isr" #n "\nisr" #n ":\n push $" #n "\n jmp isr_common\n"
+
+asm(".text\n"
+    ISR_NOERR(0) ISR_NOERR(1) ISR_NOERR(2) ISR_NOERR(3)
+    ISR_NOERR(4) ISR_NOERR(5) ISR_NOERR(6) ISR_NOERR(7)
+    ISR_ERR(8) ISR_NOERR(9) ISR_ERR(10) ISR_ERR(11)
+    ISR_ERR(12) ISR_ERR(13) ISR_ERR(14) ISR_NOERR(15)
+    ISR_NOERR(16) ISR_ERR(17) ISR_NOERR(18) ISR_NOERR(19)
+    ISR_NOERR(32) ISR_NOERR(33) ISR_NOERR(34) ISR_NOERR(35)
+    ISR_NOERR(36) ISR_NOERR(37) ISR_NOERR(38) ISR_NOERR(39)
+    ISR_NOERR(40) ISR_NOERR(41) ISR_NOERR(42) ISR_NOERR(43)
+    ISR_NOERR(44) ISR_NOERR(45) ISR_NOERR(46) ISR_NOERR(47)
+    ISR_NOERR(128) ISR_NOERR(240) ISR_NOERR(255)
+    "isr_common:\n"
+    " pusha\n"
+    " push %ds\n"
+    " push %es\n"
+    " push %fs\n"
+    " push %gs\n"
+    " mov $0x10, %ax\n"
+    " mov %ax, %ds\n"
+    " mov %ax, %es\n"
+    " push %esp\n"
+    " call interrupt_dispatch\n"
+    " add $4, %esp\n"
+    " pop %gs\n"
+    " pop %fs\n"
+    " pop %es\n"
+    " pop %ds\n"
+    " popa\n"
+    " add $8, %esp\n"
+    " iret\n");
+
+extern void isr0(), isr1(), isr2(), isr3(), isr4(), isr5(), isr6(), isr7();
+extern void isr8(), isr9(), isr10(), isr11(), isr12(), isr13(), isr14(), isr15();
+extern void isr16(), isr17(), isr18(), isr19();
+extern void isr32(), isr33(), isr34(), isr35(), isr36(), isr37(), isr38(), isr39();
+extern void isr40(), isr41(), isr42(), isr43(), isr44(), isr45(), isr46(), isr47();
+extern void isr128(), isr240(), isr255();
+
+static void (*const exception_stubs[20])() = {
+    isr0, isr1, isr2, isr3, isr4, isr5, isr6, isr7,
+    isr8, isr9, isr10, isr11, isr12, isr13, isr14, isr15,
+    isr16, isr17, isr18, isr19
+};
+
+static void (*const irq_stubs[16])() = {
+    isr32, isr33, isr34, isr35, isr36, isr37, isr38, isr39,
+    isr40, isr41, isr42, isr43, isr44, isr45, isr46, isr47
+};
+
+void set_idt_gate(uint8_t vector, uint32_t handler, uint8_t flags) {
+    idt[vector].base_low = handler & 0xFFFF;
+    idt[vector].base_high = (handler >> 16) & 0xFFFF;
+    idt[vector].selector = KERNEL_CS;
+    idt[vector].zero = 0;
+    idt[vector].flags = flags;
+}
+
+void register_interrupt_handler(uint8_t vector, interrupt_handler_t handler) {
+    handlers[vector] = handler;
+}
+
+// PIC'i 0x20-0x2F'e taşı, cascade dışındaki tüm hatları maskele
+static void init_pic() {
+    outb(0x20, 0x11);
+    outb(0xA0, 0x11);
+    outb(0x21, IRQ_BASE);
+    outb(0xA1, IRQ_BASE + 8);
+    outb(0x21, 0x04);
+    outb(0xA1, 0x02);
+    outb(0x21, 0x01);
+    outb(0xA1, 0x01);
+
+    outb(0x21, 0xFB);
+    outb(0xA1, 0xFF);
+}
+
+// ISA IRQ hattını aç; aktif kesme denetleyicisine göre PIC veya IOAPIC
+void enable_irq(uint8_t irq) {
+    irq_enabled_mask |= 1 << irq;
+
+    if(!pic_active) {
+        ioapic_route_irq(irq, IRQ_BASE + irq);
+        return;
+    }
+
+    if(irq < 8) {
+        outb(0x21, inb(0x21) & ~(1 << irq));
+    } else {
+        outb(0xA1, inb(0xA1) & ~(1 << (irq - 8)));
+    }
+}
+
+// PIC'i tamamen sustur, açık IRQ'ları IOAPIC üzerinden yeniden yönlendir
+void switch_to_ioapic() {
+    outb(0x21, 0xFF);
+    outb(0xA1, 0xFF);
+    pic_active = 0;
+
+    for(int irq = 0; irq < 16; irq++) {
+        if(irq_enabled_mask & (1 << irq))
+            ioapic_route_irq(irq, IRQ_BASE + irq);
+    }
+}
+
+void irq_eoi(uint8_t vector) {
+    if(!pic_active) {
+        lapic_eoi();
+        return;
+    }
+    if(vector >= IRQ_BASE + 8)
+        outb(0xA0, 0x20);
+    outb(0x20, 0x20);
+}
+
+void interrupt_dispatch(regs_t* regs) {
+    uint32_t vector = regs->int_no;
+
+    if(handlers[vector] != NULL) {
+        handlers[vector](regs);
+    } else if(vector < IRQ_BASE && (regs->cs & 3) == 3) {
+        // Ring 3 hatası yalnızca o task'ı sonlandırır
+        set_color(COLOR_LIGHT_RED, COLOR_BLACK);
+        kprint("\nUser task sonlandirildi: istisna ");
+        kprint_dec(vector);
+        kprint(" eip ");
+        kprint_hex(regs->eip);
+        kprint("\n");
+        set_color(COLOR_WHITE, COLOR_BLACK);
+        task_exit();
+    } else if(vector < IRQ_BASE) {
+        set_color(COLOR_LIGHT_RED, COLOR_BLACK);
+        kprint("\nCPU istisnasi: ");
+        kprint_dec(vector);
+        kprint(" hata kodu ");
+        kprint_hex(regs->err_code);
+        kprint(" eip ");
+        kprint_hex(regs->eip);
+        kprint("\n");
+        asm volatile("cli; hlt");
+    }
+
+    // Spurious kesmeye EOI gönderilmez
+    if(vector >= IRQ_BASE && vector < IRQ_BASE + 16)
+        irq_eoi(vector);
+}
+
+// IDT'yi yükle (AP'ler de çağırır)
+void load_idt() {
+    asm volatile("lidt %0" : : "m"(idt_ptr));
+}
+
+void init_idt() {
+    for(int i = 0; i < 20; i++)
+        set_idt_gate(i, (uint32_t)exception_stubs[i], IDT_GATE_INT);
+    for(int i = 0; i < 16; i++)
+        set_idt_gate(IRQ_BASE + i, (uint32_t)irq_stubs[i], IDT_GATE_INT);
+    set_idt_gate(SYSCALL_VECTOR, (uint32_t)isr128, IDT_GATE_USER);
+    set_idt_gate(WAKEUP_VECTOR, (uint32_t)isr240, IDT_GATE_INT);
+    set_idt_gate(SPURIOUS_VECTOR, (uint32_t)isr255, IDT_GATE_INT);
+
+    idt_ptr.limit = sizeof(idt) - 1;
+    idt_ptr.base = (uint32_t)&idt;
+    load_idt();
+
+    init_pic();
+}
@@ -0,0 +1,288 @@
+// ipc.c - Task'lar arası sınırlı mesaj kanalları (inline kopya veya tampon devri)
+#include "headers.h"
+
+typedef struct {
+    int in_use;
+    char name[16];
+    spinlock_t lock;
+    ipc_msg_t ring[IPC_RING_SLOTS];
+    int head;
+    volatile int count;
+
+    // Bekleyen task'lar, task id başına bir bit (MAX_TASKS <= 32)
+    uint32_t recv_waiters;
+    uint32_t send_waiters;
+
+    uint32_t sent;
+    uint32_t received;
+    uint32_t inline_bytes;      // Halkaya kopyalanan
+    uint32_t handed_bytes;      // Kopyalanmadan devredilen
+    uint32_t blocks;            // Dolu/boş kanalda uyuma sayısı
+} ipc_channel_t;
+
+static ipc_channel_t channels[IPC_MAX_CHANNELS];
+static spinlock_t ipc_lock;
+
+static ipc_channel_t* get_channel(int ch) {
+    if(ch < 0 || ch >= IPC_MAX_CHANNELS || !channels[ch].in_use)
+        return NULL;
+    return &channels[ch];
+}
+
+static void wake_mask(uint32_t mask) {
+    for(int i = 0; mask != 0; i++, mask >>= 1) {
+        if(mask & 1)
+            task_wake(i);
+    }
+}
+
+static int channel_ready(ipc_channel_t* c, int for_send) {
+    if(!c->in_use)
+        return 1;
+    return for_send ? c->count < IPC_RING_SLOTS : c->count > 0;
+}
+
+static int first_ready(const int* chans, int count, int for_send) {
+    for(int i = 0; i < count; i++) {
+        if(channel_ready(&channels[chans[i]], for_send))
+            return i;
+    }
+    return -1;
+}
+
+// Kanallardan biri hazır olana kadar bekle, hazır olanın sırasını döner.
+// Bekleyen bit'i koşul kontrolünden önce yazılır; arada gelen mesajın
+// task_wake()'i task_prepare_block() sayesinde kaybolmaz. Bit'leri yalnızca
+// bekleyen task kendisi temizler; uyandıran taraf onlara dokunmaz.
+static int wait_any(const int* chans, int count, int for_send) {
+    task_t* task = get_current_task();
+
+    while(1) {
+        int ready = first_ready(chans, count, for_send);
+        if(ready >= 0)
+            return ready;
+
+        // Idle context (kabuk) uyuyamaz: kuyruktaki task'ları çalıştırarak bekle
+        if(task == NULL) {
+            schedule();
+            asm volatile("pause");
+            continue;
+        }
+
+        uint32_t bit = 1u << task->id;
+        for(int i = 0; i < count; i++) {
+            ipc_channel_t* c = &channels[chans[i]];
+            spin_lock(&c->lock);
+            if(for_send) c->send_waiters |= bit;
+            else c->recv_waiters |= bit;
+            c->blocks++;
+            spin_unlock(&c->lock);
+        }
+
+        task_prepare_block();
+        ready = first_ready(chans, count, for_send);
+        if(ready >= 0)
+            task_cancel_block();
+        else
+            schedule();
+
+        for(int i = 0; i < count; i++) {
+            ipc_channel_t* c = &channels[chans[i]];
+            spin_lock(&c->lock);
+            if(for_send) c->send_waiters &= ~bit;
+            else c->recv_waiters &= ~bit;
+            spin_unlock(&c->lock);
+        }
+    }
+}
+
+void init_ipc() {
+    spin_init(&ipc_lock);
+    for(int i = 0; i < IPC_MAX_CHANNELS; i++) {
+        channels[i].in_use = 0;
+        spin_init(&channels[i].lock);
+    }
+}
+
+int ipc_create(const char* name) {
+    spin_lock(&ipc_lock);
+    int ch = -1;
+    for(int i = 0; i < IPC_MAX_CHANNELS; i++) {
+        if(!channels[i].in_use) {
+            ch = i;
+            break;
+        }
+    }
+    if(ch < 0) {
+        spin_unlock(&ipc_lock);
+        return -1;
+    }
+
+    ipc_channel_t* c = &channels[ch];
+    int i;
+    for(i = 0; i < 15 && name[i] != '\0'; i++)
+        c->name[i] = name[i];
+    c->name[i] = '\0';
+    c->head = 0;
+    c->count = 0;
+    c->recv_waiters = 0;
+    c->send_waiters = 0;
+    c->sent = c->received = 0;
+    c->inline_bytes = c->handed_bytes = 0;
+    c->blocks = 0;
+    c->in_use = 1;
+    spin_unlock(&ipc_lock);
+    return ch;
+}
+
+// Halkada kalan devredilmiş tamponlar serbest bırakılır, bekleyenler -1 alır
+void ipc_destroy(int ch) {
+    ipc_channel_t* c = get_channel(ch);
+    if(c == NULL)
+        return;
+
+    spin_lock(&c->lock);
+    c->in_use = 0;
+    for(int i = 0; i < c->count; i++) {
+        ipc_msg_t* slot = &c->ring[(c->head + i) % IPC_RING_SLOTS];
+        if(slot->buf)
+            kfree(slot->buf);
+    }
+    c->count = 0;
+    uint32_t waiters = c->recv_waiters | c->send_waiters;
+    spin_unlock(&c->lock);
+
+    wake_mask(waiters);
+}
+
+// Halka doluysa yer açılana kadar bekler
+static int send_msg(int ch, uint32_t type, const void* data, void* buf, uint32_t len) {
+    ipc_channel_t* c = get_channel(ch);
+    if(c == NULL)
+        return -1;
+
+    while(1) {
+        spin_lock(&c->lock);
+        if(!c->in_use) {
+            spin_unlock(&c->lock);
+            return -1;
+        }
+        if(c->count < IPC_RING_SLOTS)
+            break;
+        spin_unlock(&c->lock);
+        wait_any(&ch, 1, 1);
+    }
+
+    ipc_msg_t* slot = &c->ring[(c->head + c->count) % IPC_RING_SLOTS];
+    slot->type = type;
+    slot->len = len;
+    slot->buf = buf;
+    if(buf) {
+        c->handed_bytes += len;
+    } else {
+        memcpy(slot->data, data, len);
+        c->inline_bytes += len;
+    }
+    c->count++;
+    c->sent++;
+
+    uint32_t waiters = c->recv_waiters;
+    spin_unlock(&c->lock);
+
+    wake_mask(waiters);
+    return 0;
+}
+
+int ipc_send(int ch, uint32_t type, const void* data, uint32_t len) {
+    if(len > IPC_INLINE_MAX)
+        return -1;
+    return send_msg(ch, type, data, NULL, len);
+}
+
+// buf kmalloc'tan gelmeli; başarılı dönüşten sonra gönderen ona dokunmaz
+int ipc_send_buf(int ch, uint32_t type, void* buf, uint32_t len) {
+    if(buf == NULL)
+        return -1;
+    return send_msg(ch, type, NULL, buf, len);
+}
+
+int ipc_recv(int ch, ipc_msg_t* msg) {
+    ipc_channel_t* c = get_channel(ch);
+    if(c == NULL)
+        return -1;
+
+    while(1) {
+        spin_lock(&c->lock);
+        if(!c->in_use) {
+            spin_unlock(&c->lock);
+            return -1;
+        }
+        if(c->count > 0)
+            break;
+        spin_unlock(&c->lock);
+        wait_any(&ch, 1, 0);
+    }
+
+    // Yalnızca başlık ve kullanılan inline byte'lar kopyalanır
+    ipc_msg_t* slot = &c->ring[c->head];
+    msg->type = slot->type;
+    msg->len = slot->len;
+    msg->buf = slot->buf;
+    if(slot->buf == NULL)
+        memcpy(msg->data, slot->data, slot->len);
+    c->head = (c->head + 1) % IPC_RING_SLOTS;
+    c->count--;
+    c->received++;
+
+    uint32_t waiters = c->send_waiters;
+    spin_unlock(&c->lock);
+
+    wake_mask(waiters);
+    return 0;
+}
+
+// Kanallardan birinde mesaj olana kadar bekle; hazır kanalın chans[] sırasını döner
+int ipc_wait(const int* chans, int count) {
+    if(count <= 0)
+        return -1;
+    for(int i = 0; i < count; i++) {
+        if(get_channel(chans[i]) == NULL)
+            return -1;
+    }
+    return wait_any(chans, count, 0);
+}
+
+void list_channels() {
+    int shown = 0;
+    for(int i = 0; i < IPC_MAX_CHANNELS; i++) {
+        ipc_channel_t* c = &channels[i];
+        if(!c->in_use)
+            continue;
+
+        if(shown++ == 0) {
+            kprint("ID  Name            Kuyruk  Gonderilen  Alinan  Inline B  Devredilen B  Uyuma\n");
+        }
+        kprint_dec(i);
+        kprint(i < 10 ? "   " : "  ");
+        kprint(c->name);
+        for(int j = strlen(c->name); j < 16; j++)
+            kprint(" ");
+        kprint_dec(c->count);
+        kprint("/");
+        kprint_dec(IPC_RING_SLOTS);
+        kprint("  ");
+        kprint_dec(c->sent);
+        kprint("  ");
+        kprint_dec(c->received);
+        kprint("  ");
+        kprint_dec(c->inline_bytes);
+        kprint("  ");
+        kprint_dec(c->handed_bytes);
+        kprint("  ");
+        kprint_dec(c->blocks);
+        kprint("\n");
+    }
+
+    if(shown == 0)
+        kprint("Acik kanal yok.\n");
+}
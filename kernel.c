@@ -1,20 +1,76 @@
 #include "headers.h"
 
+// Kernel giriş noktası: boot sektörü buraya atlar. Düz binary'de bss
+// bulunmadığı için önce sıfırlanır.
+asm(".section .text.entry\n"
+    ".globl _start\n"
+    "_start:\n"
+    " mov $__bss_start, %edi\n"
+    " mov $__bss_end, %ecx\n"
+    " sub %edi, %ecx\n"
+    " xor %eax, %eax\n"
+    " cld\n"
+    " rep stosb\n"
+    " call kernel_main\n"
+    "1:\n"
+    " cli\n"
+    " hlt\n"
+    " jmp 1b\n"
+    ".previous\n");
+
 // Kernel global değişkenleri
 static char cmd_buffer[256];
 static int cmd_index = 0;
 
+// Açılış ölçümleri
+static boot_info_t boot_info;
+static uint64_t tsc_kernel_entry = 0;
+static uint64_t tsc_init_done = 0;
+static uint32_t tsc_mhz = 0;
+
+static void calibrate_tsc() {
+    uint64_t start = rdtsc();
+    pit_delay_us(10000);
+    tsc_mhz = (uint32_t)(rdtsc() - start) / 10000;
+}
+
+// 64-bit bölme yok (libgcc bağlanmıyor): sığana kadar ikisini de kaydır
+static uint32_t cycles_to_us(uint64_t cycles) {
+    uint32_t mhz = tsc_mhz;
+    while((cycles >> 32) && mhz > 1) {
+        cycles >>= 1;
+        mhz >>= 1;
+    }
+    if(mhz == 0)
+        return 0;
+    return (uint32_t)cycles / mhz;
+}
+
 // Built-in komutlar
 void cmd_help() {
     kprint("DivineOS Komutlar:\n");
     kprint("  help     - Bu yardim mesajini goster\n");
     kprint("  clear    - Ekrani temizle\n");
     kprint("  mem      - Bellek durumunu goster\n");
+    kprint("  mem hist - Ayirma boyutu histogrami\n");
+    kprint("  mem sites - Cagri noktasi basina bellek\n");
     kprint("  tasks    - Caliskan task'lari listele\n");
+    kprint("  cpus     - CPU'lari ve run queue'lari listele\n");
     kprint("  chaos    - Kaos modu (rastgele grafikler)\n");
     kprint("  plasma   - Plasma efekti\n");
     kprint("  mandel   - Mandelbrot fractal\n");
     kprint("  spiral   - Spiral animasyon\n");
+    kprint("  render   - Render hatti istatistikleri\n");
+    kprint("  ls       - initrd dosyalarini listele\n");
+    kprint("  cat X    - X dosyasini goster\n");
+    kprint("  boot     - Acilis asamalarinin sureleri\n");
+    kprint("  disk     - Disk ve blok onbellegi istatistikleri\n");
+    kprint("  disk bench - Sirali okuma hiz testi\n");
+    kprint("  ipc      - IPC kanallarini listele\n");
+    kprint("  ipc bench - Kanal uzerinden mesaj hiz testi\n");
+    kprint("  syscalls - Sistem cagrisi sayac ve gecikmeleri\n");
+    kprint("  user bench - Ring 3'ten int 0x80 / SYSENTER gidis-donus\n");
+    kprint("  user crash - Hatali user task'i (kernel ayakta kalir)\n");
     kprint("  reboot   - Sistemi yeniden baslat\n");
 }
 
@@ -23,20 +79,85 @@ void cmd_clear() {
 }
 
 void cmd_mem() {
-    uint32_t total = get_total_memory();
-    uint32_t used = get_used_memory();
-    uint32_t free = total - used;
+    heap_stats_t stats;
+    get_heap_stats(&stats);
+    uint32_t free = stats.total - stats.used;
     
     kprint("=== Bellek Durumu ===\n");
     kprint("Toplam: ");
-    kprint_dec(total / 1024);
+    kprint_dec(stats.total / 1024);
     kprint(" KB\n");
     kprint("Kullanilan: ");
-    kprint_dec(used / 1024);
-    kprint(" KB\n");
+    kprint_dec(stats.used / 1024);
+    kprint(" KB (zirve ");
+    kprint_dec(stats.peak / 1024);
+    kprint(" KB)\n");
     kprint("Bos: ");
     kprint_dec(free / 1024);
     kprint(" KB\n");
+    kprint("Bloklar: ");
+    kprint_dec(stats.used_blocks);
+    kprint(" dolu, ");
+    kprint_dec(stats.free_blocks);
+    kprint(" bos\n");
+    kprint("Sayfa havuzu: ");
+    kprint_dec(stats.free_pages);
+    kprint(" bos, ");
+    kprint_dec(stats.zeroed_pages);
+    kprint(" sifirli\n");
+    kprint("En buyuk bos blok: ");
+    kprint_dec(stats.largest_free);
+    kprint(" B\n");
+    kprint("Parcalanma: %");
+    kprint_dec(stats.fragmentation);
+    kprint("\n");
+    kprint("kmalloc: ");
+    kprint_dec(stats.alloc_count);
+    kprint("  kfree: ");
+    kprint_dec(stats.free_count);
+    kprint("  basarisiz: ");
+    kprint_dec(stats.failed_count);
+    kprint("\n");
+}
+
+void cmd_mem_hist() {
+    heap_stats_t stats;
+    get_heap_stats(&stats);
+
+    kprint("=== Ayirma Boyutu Histogrami ===\n");
+    for(int i = 0; i < HEAP_HIST_BUCKETS; i++) {
+        if(stats.histogram[i] == 0)
+            continue;
+        kprint(">= ");
+        kprint_dec(1u << i);
+        kprint(" B: ");
+        kprint_dec(stats.histogram[i]);
+        kprint("\n");
+    }
+}
+
+void cmd_mem_sites() {
+#if HEAP_TRACK_CALLERS
+    const heap_site_t* sites = get_heap_sites();
+
+    kprint("=== Cagri Noktalari ===\n");
+    kprint("Adres       Canli (B)  Ayirma\n");
+    for(int i = 0; i < HEAP_MAX_SITES; i++) {
+        if(sites[i].allocs == 0)
+            continue;
+        if(sites[i].caller == HEAP_SITE_OTHER)
+            kprint("diger     ");
+        else
+            kprint_hex(sites[i].caller);
+        kprint("  ");
+        kprint_dec(sites[i].live_bytes);
+        kprint("  ");
+        kprint_dec(sites[i].allocs);
+        kprint("\n");
+    }
+#else
+    kprint("Cagri noktasi takibi kapali (HEAP_TRACK_CALLERS).\n");
+#endif
 }
 
 void cmd_tasks() {
@@ -44,6 +165,53 @@ void cmd_tasks() {
     list_tasks();
 }
 
+void cmd_cpus() {
+    kprint("=== CPU'lar ===\n");
+    list_cpus();
+}
+
+void cmd_ls() {
+    const char* name;
+    vfs_stat_t st;
+    int count = 0;
+
+    for(int i = 0; vfs_readdir(i, &name, &st) == 0; i++) {
+        // Boyut sütunu 8 karakter
+        int digits = 1;
+        for(uint32_t n = st.size; n >= 10; n /= 10)
+            digits++;
+        for(int j = digits; j < 8; j++)
+            kprint(" ");
+        kprint_dec(st.size);
+        kprint("  ");
+        kprint(name);
+        kprint("\n");
+        count++;
+    }
+
+    if(count == 0)
+        kprint("initrd bos.\n");
+}
+
+void cmd_cat(const char* path) {
+    int fd = vfs_open(path);
+    if(fd < 0) {
+        kprint("Dosya bulunamadi: ");
+        kprint(path);
+        kprint("\n");
+        return;
+    }
+
+    // Veri arşivden kopyalanmadan doğrudan ekrana yazılır
+    uint32_t size;
+    const char* data = vfs_map(fd, &size);
+    for(uint32_t i = 0; i < size; i++)
+        kprint_char(data[i]);
+    if(size > 0 && data[size - 1] != '\n')
+        kprint("\n");
+    vfs_close(fd);
+}
+
 void cmd_chaos() {
     kprint("Kaos modu baslatiliyor...\n");
     // Rastgele piksel efekti
@@ -55,39 +223,58 @@ void cmd_chaos() {
     }
 }
 
-void cmd_plasma() {
-    kprint("Plasma efekti baslatiliyor...\n");
-    for(int y = 0; y < 200; y++) {
-        for(int x = 0; x < 320; x++) {
-            int color = (int)(128 + 127 * sin(x / 16.0)) % 256;
-            plot_pixel(x, y, color);
-        }
+static void plasma_tile(int x0, int y0, int x1, int y1, uint8_t* fb) {
+    // Renk yalnızca x'e bağlı, satır bir kez hesaplanıp kopyalanır
+    uint8_t row[RENDER_TILE_W];
+    for(int x = x0; x < x1; x++)
+        row[x - x0] = (int)(128 + 127 * sin(x / 16.0)) % 256;
+
+    for(int y = y0; y < y1; y++) {
+        for(int x = x0; x < x1; x++)
+            fb[y * RENDER_WIDTH + x] = row[x - x0];
     }
 }
 
-void cmd_mandelbrot() {
-    kprint("Mandelbrot fractal hesaplaniyor...\n");
-    for(int py = 0; py < 200; py++) {
-        for(int px = 0; px < 320; px++) {
-            float x0 = (px - 160.0f) / 80.0f;
-            float y0 = (py - 100.0f) / 80.0f;
+static void mandel_tile(int x0, int y0, int x1, int y1, uint8_t* fb) {
+    for(int py = y0; py < y1; py++) {
+        for(int px = x0; px < x1; px++) {
+            float cx = (px - 160.0f) / 80.0f;
+            float cy = (py - 100.0f) / 80.0f;
             float x = 0, y = 0;
             int iteration = 0;
             int max_iteration = 100;
             
             while(x*x + y*y <= 4 && iteration < max_iteration) {
-                float xtemp = x*x - y*y + x0;
-                y = 2*x*y + y0;
+                float xtemp = x*x - y*y + cx;
+                y = 2*x*y + cy;
                 x = xtemp;
                 iteration++;
             }
             
-            int color = iteration * 255 / max_iteration;
-            plot_pixel(px, py, color);
+            fb[py * RENDER_WIDTH + px] = iteration * 255 / max_iteration;
         }
     }
 }
 
+void cmd_plasma() {
+    kprint("Plasma efekti baslatiliyor...\n");
+    if(render_submit(plasma_tile) != 0)
+        kprint("Render hatti mesgul.\n");
+}
+
+void cmd_mandelbrot() {
+    kprint("Mandelbrot fractal hesaplaniyor...\n");
+    if(render_submit(mandel_tile) != 0)
+        kprint("Render hatti mesgul.\n");
+}
+
+void cmd_render() {
+    kprint("=== Render Hatti ===\n");
+    if(render_busy())
+        kprint("Durum: kare isleniyor\n");
+    render_stats();
+}
+
 void cmd_spiral() {
     kprint("Spiral ciziliyor...\n");
     float angle = 0;
@@ -106,6 +293,295 @@ void cmd_spiral() {
     }
 }
 
+void cmd_boot() {
+    kprint("=== Acilis Sureleri ===\n");
+    kprint("Kernel: ");
+    kprint_dec(boot_info.kernel_sectors);
+    kprint(" sektor, ");
+    if(boot_info.load_method == BOOT_METHOD_LBA) {
+        kprint("LBA (parca ");
+        kprint_dec(boot_info.last_chunk);
+        kprint(" sektor)\n");
+    } else {
+        kprint("CHS\n");
+    }
+    kprint("TSC: ");
+    kprint_dec(tsc_mhz);
+    kprint(" MHz\n");
+    kprint("Firmware:  ");
+    kprint_dec(cycles_to_us(boot_info.tsc_entry) / 1000);
+    kprint(" ms\n");
+    kprint("Yukleme:   ");
+    kprint_dec(cycles_to_us(boot_info.tsc_loaded - boot_info.tsc_entry));
+    kprint(" us\n");
+    kprint("Gecis:     ");
+    kprint_dec(cycles_to_us(tsc_kernel_entry - boot_info.tsc_loaded));
+    kprint(" us\n");
+    kprint("Init:      ");
+    kprint_dec(cycles_to_us(tsc_init_done - tsc_kernel_entry));
+    kprint(" us\n");
+}
+
+// KB/s; us 32-bit taşmasın diye ms üzerinden
+static uint32_t kb_per_sec(uint32_t kb, uint32_t us) {
+    uint32_t ms = us / 1000;
+    if(ms == 0)
+        ms = 1;
+    return kb * 1000 / ms;
+}
+
+void cmd_disk() {
+    if(!ata_present()) {
+        kprint("Disk bulunamadi.\n");
+        return;
+    }
+
+    bcache_stats_t stats;
+    get_bcache_stats(&stats);
+
+    kprint("=== Disk ===\n");
+    kprint("Model: ");
+    kprint(ata_model());
+    kprint("\nBoyut: ");
+    kprint_dec(ata_sectors() / 2048);
+    kprint(" MB, mod: ");
+    kprint(ata_dma_enabled() ? "DMA\n" : "PIO\n");
+
+    uint32_t total = stats.hits + stats.misses;
+    kprint("Onbellek: ");
+    kprint_dec(stats.hits);
+    kprint(" isabet, ");
+    kprint_dec(stats.misses);
+    kprint(" iska (%");
+    kprint_dec(total ? stats.hits * 100 / total : 0);
+    kprint(")\n");
+    kprint("Onden okuma: ");
+    kprint_dec(stats.readahead);
+    kprint(" blok, ");
+    kprint_dec(stats.readahead_hits);
+    kprint(" kullanildi\n");
+    kprint("Geri yazma: ");
+    kprint_dec(stats.writebacks);
+    kprint(", atilan: ");
+    kprint_dec(stats.evictions);
+    kprint("\n");
+
+    uint32_t read_kb = (uint32_t)(stats.bytes_read >> 10);
+    uint32_t write_kb = (uint32_t)(stats.bytes_written >> 10);
+    kprint("Okunan: ");
+    kprint_dec(read_kb);
+    kprint(" KB, yazilan: ");
+    kprint_dec(write_kb);
+    kprint(" KB\n");
+    kprint("Disk hizi: ");
+    kprint_dec(kb_per_sec(read_kb + write_kb, cycles_to_us(stats.io_cycles)));
+    kprint(" KB/s\n");
+}
+
+// Sıralı soğuk okuma (önden okuma dahil), ardından son blokları önbellekten tekrar oku
+void cmd_disk_bench() {
+    if(!ata_present()) {
+        kprint("Disk bulunamadi.\n");
+        return;
+    }
+
+    uint32_t blocks = 256;
+    uint32_t disk_blocks = ata_sectors() / BCACHE_BLOCK_SECTORS;
+    if(blocks > disk_blocks)
+        blocks = disk_blocks;
+
+    uint8_t* buf = kmalloc(BCACHE_BLOCK_SIZE);
+    if(!buf) {
+        kprint("Bellek yetersiz.\n");
+        return;
+    }
+
+    uint64_t start = rdtsc();
+    for(uint32_t i = 0; i < blocks; i++) {
+        if(bcache_read(i, buf) != 0) {
+            kprint("Okuma hatasi, blok ");
+            kprint_dec(i);
+            kprint("\n");
+            kfree(buf);
+            return;
+        }
+    }
+    uint32_t cold_us = cycles_to_us(rdtsc() - start);
+
+    uint32_t warm = blocks < BCACHE_BLOCKS / 2 ? blocks : BCACHE_BLOCKS / 2;
+    start = rdtsc();
+    for(int pass = 0; pass < 16; pass++) {
+        for(uint32_t i = blocks - warm; i < blocks; i++)
+            bcache_read(i, buf);
+    }
+    uint32_t warm_us = cycles_to_us(rdtsc() - start);
+    kfree(buf);
+
+    uint32_t kb = blocks * (BCACHE_BLOCK_SIZE / 1024);
+    kprint("Sirali okuma: ");
+    kprint_dec(kb);
+    kprint(" KB, ");
+    kprint_dec(cold_us);
+    kprint(" us, ");
+    kprint_dec(kb_per_sec(kb, cold_us));
+    kprint(" KB/s\n");
+
+    kb = 16 * warm * (BCACHE_BLOCK_SIZE / 1024);
+    kprint("Onbellekten:  ");
+    kprint_dec(kb);
+    kprint(" KB, ");
+    kprint_dec(warm_us);
+    kprint(" us, ");
+    kprint_dec(kb_per_sec(kb, warm_us));
+    kprint(" KB/s\n");
+}
+
+void cmd_ipc() {
+    kprint("=== IPC Kanallari ===\n");
+    list_channels();
+}
+
+#define IPC_BENCH_MSGS 1000
+#define IPC_BENCH_BUFS 4
+#define IPC_BENCH_BUF_SIZE 1024
+
+static int bench_ctl = -1;
+static int bench_small = -1;
+static int bench_large = -1;
+static int bench_return = -1;
+
+// Küçük mesajları inline, büyükleri sabit bir tampon havuzundan devrederek gönderir.
+// Alıcı tamponları bench_return üzerinden geri yollar; mesaj başına heap ayırma yok.
+static void ipc_producer() {
+    uint8_t* pool[IPC_BENCH_BUFS];
+    int free_count = 0;
+    for(int i = 0; i < IPC_BENCH_BUFS; i++) {
+        pool[free_count] = kmalloc(IPC_BENCH_BUF_SIZE);
+        if(pool[free_count])
+            free_count++;
+    }
+    int pool_size = free_count;
+
+    ipc_msg_t msg;
+    while(ipc_recv(bench_ctl, &msg) == 0) {
+        uint32_t count;
+        memcpy(&count, msg.data, sizeof(count));
+
+        for(uint32_t i = 0; i < count; i++) {
+            if((i & 1) || pool_size == 0) {
+                ipc_send(bench_small, 1, &i, sizeof(i));
+                continue;
+            }
+
+            if(free_count == 0) {
+                ipc_recv(bench_return, &msg);
+                pool[free_count++] = msg.buf;
+            }
+            uint8_t* buf = pool[--free_count];
+            buf[0] = (uint8_t)i;
+            ipc_send_buf(bench_large, 2, buf, IPC_BENCH_BUF_SIZE);
+        }
+
+        // Dağıtılan tamponları bir sonraki tur için topla
+        while(free_count < pool_size) {
+            ipc_recv(bench_return, &msg);
+            pool[free_count++] = msg.buf;
+        }
+    }
+}
+
+void cmd_ipc_bench() {
+    if(bench_ctl < 0) {
+        bench_ctl = ipc_create("bench-ctl");
+        bench_small = ipc_create("bench-small");
+        bench_large = ipc_create("bench-large");
+        bench_return = ipc_create("bench-return");
+        if(bench_ctl < 0 || bench_small < 0 || bench_large < 0 || bench_return < 0 ||
+           create_task(ipc_producer, "ipc-producer", 1) < 0) {
+            kprint("IPC testi baslatilamadi.\n");
+            ipc_destroy(bench_ctl);
+            ipc_destroy(bench_small);
+            ipc_destroy(bench_large);
+            ipc_destroy(bench_return);
+            bench_ctl = -1;
+            return;
+        }
+    }
+
+    uint32_t count = IPC_BENCH_MSGS;
+    uint32_t received = 0;
+    uint32_t handed = 0;
+    int chans[2] = { bench_small, bench_large };
+    ipc_msg_t msg;
+
+    uint64_t start = rdtsc();
+    ipc_send(bench_ctl, 0, &count, sizeof(count));
+    while(received < count) {
+        int which = ipc_wait(chans, 2);
+        if(which < 0 || ipc_recv(chans[which], &msg) != 0)
+            break;
+        if(msg.buf) {
+            handed += msg.len;
+            ipc_send_buf(bench_return, 0, msg.buf, msg.len);
+        }
+        received++;
+    }
+    uint32_t us = cycles_to_us(rdtsc() - start);
+
+    kprint("Mesaj: ");
+    kprint_dec(received);
+    kprint(", devredilen: ");
+    kprint_dec(handed / 1024);
+    kprint(" KB, ");
+    kprint_dec(us);
+    kprint(" us (mesaj basina ");
+    // us * 1000 ~4.3 sn sonra taşar: önce böl
+    kprint_dec(received ? us / received * 1000 + (us % received) * 1000 / received : 0);
+    kprint(" ns)\n");
+    list_channels();
+}
+
+void cmd_syscalls() {
+    kprint("=== Sistem Cagrilari ===\n");
+    list_syscalls();
+}
+
+void cmd_user_bench() {
+    user_bench_result.done = 0;
+    user_bench_result.sysenter_cycles = 0;
+    int id = create_user_task(user_bench_main, "user-bench");
+    if(id < 0)
+        return;
+
+    // Kabuk idle context'tir: task sonucu yazana ya da ölene kadar kuyruğu çalıştır
+    while(!user_bench_result.done && get_task_state(id) != TASK_TERMINATED) {
+        schedule();
+        asm volatile("pause");
+    }
+    if(!user_bench_result.done) {
+        kprint("User task sonuc yazmadan sonlandi.\n");
+        return;
+    }
+
+    kprint("Bos cagri gidis-donus (");
+    kprint_dec(user_bench_result.iterations);
+    kprint(" tekrar):\n");
+    kprint("  int 0x80: ");
+    kprint_dec(user_bench_result.int80_cycles);
+    kprint(" cycle\n");
+    kprint("  SYSENTER: ");
+    if(sysenter_enabled()) {
+        kprint_dec(user_bench_result.sysenter_cycles);
+        kprint(" cycle\n");
+    } else {
+        kprint("desteklenmiyor\n");
+    }
+}
+
+void cmd_user_crash() {
+    create_user_task(user_crash_main, "user-crash");
+}
+
 void cmd_reboot() {
     kprint("Sistem yeniden baslatiliyor...\n");
     // Keyboard controller üzerinden reboot
@@ -128,8 +604,14 @@ void process_command(char* cmd) {
         cmd_clear();
     } else if(strcmp(cmd, "mem") == 0) {
         cmd_mem();
+    } else if(strcmp(cmd, "mem hist") == 0) {
+        cmd_mem_hist();
+    } else if(strcmp(cmd, "mem sites") == 0) {
+        cmd_mem_sites();
     } else if(strcmp(cmd, "tasks") == 0) {
         cmd_tasks();
+    } else if(strcmp(cmd, "cpus") == 0) {
+        cmd_cpus();
     } else if(strcmp(cmd, "chaos") == 0) {
         cmd_chaos();
     } else if(strcmp(cmd, "plasma") == 0) {
@@ -138,8 +620,30 @@ void process_command(char* cmd) {
         cmd_mandelbrot();
     } else if(strcmp(cmd, "spiral") == 0) {
         cmd_spiral();
+    } else if(strcmp(cmd, "render") == 0) {
+        cmd_render();
     } else if(strcmp(cmd, "reboot") == 0) {
         cmd_reboot();
+    } else if(strcmp(cmd, "ls") == 0) {
+        cmd_ls();
+    } else if(strncmp(cmd, "cat ", 4) == 0) {
+        cmd_cat(cmd + 4);
+    } else if(strcmp(cmd, "boot") == 0) {
+        cmd_boot();
+    } else if(strcmp(cmd, "disk") == 0) {
+        cmd_disk();
+    } else if(strcmp(cmd, "disk bench") == 0) {
+        cmd_disk_bench();
+    } else if(strcmp(cmd, "ipc") == 0) {
+        cmd_ipc();
+    } else if(strcmp(cmd, "ipc bench") == 0) {
+        cmd_ipc_bench();
+    } else if(strcmp(cmd, "syscalls") == 0) {
+        cmd_syscalls();
+    } else if(strcmp(cmd, "user bench") == 0) {
+        cmd_user_bench();
+    } else if(strcmp(cmd, "user crash") == 0) {
+        cmd_user_crash();
     } else if(strlen(cmd) > 0) {
         kprint("Bilinmeyen komut: ");
         kprint(cmd);
@@ -149,6 +653,11 @@ void process_command(char* cmd) {
 
 // Kernel ana fonksiyonu
 void kernel_main() {
+    tsc_kernel_entry = rdtsc();
+    
+    // Boot sektörünün bıraktığı bilgi sayfa 0'da, sayfalamadan önce kopyala
+    memcpy(&boot_info, (void*)BOOT_INFO_ADDR, sizeof(boot_info_t));
+    
     // Ekranı başlat
     init_screen();
     
@@ -160,10 +669,25 @@ void kernel_main() {
     set_color(COLOR_WHITE, COLOR_BLACK);
     kprint("\n");
     
+    // Kernel GDT ve IDT'yi kur
+    init_gdt();
+    init_idt();
+    kprint("[OK] GDT/IDT kuruldu\n");
+    
+    // Sayfalamayı başlat
+    init_paging();
+    kprint("[OK] Sayfalama etkinlestirildi\n");
+    
     // Bellek yöneticisini başlat
     init_memory();
     kprint("[OK] Bellek yoneticisi baslatildi\n");
     
+    // initrd'yi tara
+    init_vfs();
+    kprint("[OK] initrd: ");
+    kprint_dec(vfs_initrd_size() / 1024);
+    kprint(" KB\n");
+    
     // Klavye sürücüsünü başlat
     init_keyboard();
     kprint("[OK] Klavye surucu baslatildi\n");
@@ -172,6 +696,37 @@ void kernel_main() {
     init_scheduler();
     kprint("[OK] Task scheduler baslatildi\n");
     
+    init_ipc();
+    
+    // TSS, int 0x80 kapısı ve SYSENTER; user sayfaları AP'lerden önce açılır
+    init_syscalls();
+    kprint(sysenter_enabled() ? "[OK] Sistem cagrilari (SYSENTER)\n"
+                              : "[OK] Sistem cagrilari (int 0x80)\n");
+    
+    // AP'leri başlat, PIC'ten LAPIC/IOAPIC'e geç
+    init_smp();
+    kprint("[OK] SMP baslatildi (");
+    kprint_dec(get_cpu_count());
+    kprint(" CPU)\n");
+    
+    // Diski IRQ14 üzerinden sür, üstüne blok önbelleğini kur
+    init_ata();
+    init_bcache();
+    if(ata_present()) {
+        kprint("[OK] Disk: ");
+        kprint_dec(ata_sectors() / 2048);
+        kprint(ata_dma_enabled() ? " MB, DMA\n" : " MB, PIO\n");
+    }
+    
+    // Render worker'larını başlat
+    init_render();
+    kprint("[OK] Render hatti baslatildi\n");
+    
+    asm volatile("sti");
+    
+    calibrate_tsc();
+    tsc_init_done = rdtsc();
+    
     kprint("\n");
     set_color(COLOR_LIGHT_GREEN, COLOR_BLACK);
     kprint("Hosgeldiniz! 'help' yazarak baslayabilirsiniz.\n");
@@ -220,6 +775,67 @@ void outb(uint16_t port, uint8_t val) {
     asm volatile("outb %0, %1" : : "a"(val), "Nd"(port));
 }
 
+uint16_t inw(uint16_t port) {
+    uint16_t ret;
+    asm volatile("inw %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+void outw(uint16_t port, uint16_t val) {
+    asm volatile("outw %0, %1" : : "a"(val), "Nd"(port));
+}
+
+uint32_t inl(uint16_t port) {
+    uint32_t ret;
+    asm volatile("inl %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+void outl(uint16_t port, uint32_t val) {
+    asm volatile("outl %0, %1" : : "a"(val), "Nd"(port));
+}
+
+// CPU yardımcı fonksiyonları
+void cpuid(uint32_t leaf, uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx) {
+    asm volatile("cpuid"
+                 : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
+                 : "a"(leaf), "c"(0));
+}
+
+uint64_t rdmsr(uint32_t msr) {
+    uint32_t lo, hi;
+    asm volatile("rdmsr" : "=a"(lo), "=d"(hi) : "c"(msr));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+void wrmsr(uint32_t msr, uint64_t val) {
+    asm volatile("wrmsr" : : "c"(msr), "a"((uint32_t)val), "d"((uint32_t)(val >> 32)));
+}
+
+// PIT kanal 2 ile bekle (en fazla ~55 ms)
+void pit_delay_us(uint32_t us) {
+    uint32_t count = us * 1193 / 1000;
+    if(count == 0)
+        count = 1;
+    if(count > 0xFFFF)
+        count = 0xFFFF;
+
+    uint8_t gate = inb(0x61) & 0xFC;
+    outb(0x61, gate);
+    outb(0x43, 0xB0);
+    outb(0x42, count & 0xFF);
+    outb(0x42, (count >> 8) & 0xFF);
+    outb(0x61, gate | 0x01);
+
+    while(!(inb(0x61) & 0x20));
+}
+
+uint64_t rdtsc() {
+    uint32_t lo, hi;
+    asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
 // Basit string fonksiyonları
 int strlen(const char* str) {
     int len = 0;
@@ -235,6 +851,17 @@ int strcmp(const char* s1, const char* s2) {
     return *(unsigned char*)s1 - *(unsigned char*)s2;
 }
 
+int strncmp(const char* s1, const char* s2, size_t n) {
+    while(n > 0 && *s1 && (*s1 == *s2)) {
+        s1++;
+        s2++;
+        n--;
+    }
+    if(n == 0)
+        return 0;
+    return *(unsigned char*)s1 - *(unsigned char*)s2;
+}
+
 // Basit matematik fonksiyonları
 float sin(float x) {
     float result = x;
@@ -26,9 +26,16 @@ static char key_buffer[256];
 static int buffer_head = 0;
 static int buffer_tail = 0;
 
+static void keyboard_irq(regs_t* regs) {
+    (void)regs;
+    keyboard_handler();
+}
+
 void init_keyboard() {
     buffer_head = 0;
     buffer_tail = 0;
+    register_interrupt_handler(IRQ_BASE + 1, keyboard_irq);
+    enable_irq(1);
 }
 
 void keyboard_handler() {
@@ -62,13 +69,14 @@ void keyboard_handler() {
             }
         }
     }
-
-    outb(0x20, 0x20);
 }
 
 char get_key() {
     while(buffer_head == buffer_tail) {
-        asm volatile("hlt");
+        // Boş zamanı hazır task'lara ve sayfa sıfırlamaya harca, iş kalmadıysa uyu
+        schedule();
+        if(!zero_idle_page())
+            cpu_idle();
     }
 
     char key = key_buffer[buffer_tail];
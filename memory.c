@@ -4,6 +4,58 @@
 static mem_block_t* heap_start = NULL;
 static uint32_t total_memory = HEAP_SIZE;
 static uint32_t used_memory = 0;
+static uint32_t peak_memory = 0;
+
+// İstatistik sayaçları
+static uint32_t alloc_count = 0;
+static uint32_t free_count = 0;
+static uint32_t failed_count = 0;
+static uint32_t size_histogram[HEAP_HIST_BUCKETS];
+
+#if HEAP_TRACK_CALLERS
+static heap_site_t call_sites[HEAP_MAX_SITES];
+#endif
+
+// kzalloc'un havuzdan verdiği sayfalar: kfree'de istatistik düşülebilsin diye
+// sayfa başına çağıran (0: kzalloc üzerinden verilmedi)
+static uint32_t pool_page_caller[PAGE_POOL_PAGES];
+
+// Sayfa havuzu: içeriği bilinmeyen (kirli) ve önceden sıfırlanmış boş sayfalar
+static uint32_t dirty_pages[PAGE_POOL_PAGES];
+static uint32_t zeroed_pages[PAGE_POOL_PAGES];
+static int dirty_count = 0;
+static int zeroed_count = 0;
+static int zeroing_active = 0;
+static int has_sse2 = 0;
+
+// Heap ve sayfa havuzu CPU'lar arasında paylaşılır
+static spinlock_t heap_lock;
+static spinlock_t page_lock;
+
+// Boyutun log2 kovası (1 -> 0, 2-3 -> 1, 4-7 -> 2, ...)
+static int size_bucket(uint32_t size) {
+    int bucket = 0;
+    while(size > 1 && bucket < HEAP_HIST_BUCKETS - 1) {
+        size >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+#if HEAP_TRACK_CALLERS
+// Çağrı noktasının slotunu bul; tablo doluysa son slot "diğer" olarak kullanılır
+static heap_site_t* find_site(uint32_t caller) {
+    for(int i = 0; i < HEAP_MAX_SITES - 1; i++) {
+        if(call_sites[i].caller == caller)
+            return &call_sites[i];
+        if(call_sites[i].caller == 0) {
+            call_sites[i].caller = caller;
+            return &call_sites[i];
+        }
+    }
+    return &call_sites[HEAP_MAX_SITES - 1];
+}
+#endif
 
 void init_memory() {
     heap_start = (mem_block_t*)HEAP_START;
@@ -11,15 +63,47 @@ void init_memory() {
     heap_start->is_free = 1;
     heap_start->next = NULL;
     used_memory = sizeof(mem_block_t);
+    peak_memory = used_memory;
+
+    alloc_count = 0;
+    free_count = 0;
+    failed_count = 0;
+    for(int i = 0; i < HEAP_HIST_BUCKETS; i++)
+        size_histogram[i] = 0;
+
+#if HEAP_TRACK_CALLERS
+    for(int i = 0; i < HEAP_MAX_SITES; i++) {
+        call_sites[i].caller = 0;
+        call_sites[i].live_bytes = 0;
+        call_sites[i].allocs = 0;
+    }
+    call_sites[HEAP_MAX_SITES - 1].caller = HEAP_SITE_OTHER;
+#endif
+    for(int i = 0; i < PAGE_POOL_PAGES; i++)
+        pool_page_caller[i] = 0;
+
+    // Tüm havuz sayfaları kirli başlar, idle döngüsü sıfırlar.
+    // Ters sırayla itilir, düşük adresler önce verilsin.
+    dirty_count = 0;
+    zeroed_count = 0;
+    for(int i = PAGE_POOL_PAGES - 1; i >= 0; i--) {
+        dirty_pages[dirty_count++] = PAGE_POOL_START + i * PAGE_SIZE;
+    }
+    zeroing_active = 1;
+
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+    has_sse2 = (edx & CPUID_EDX_SSE2) != 0;
 }
 
-void* kmalloc(uint32_t size) {
+static void* heap_alloc(uint32_t size, uint32_t caller) {
     if(size == 0)
         return NULL;
 
     // 4-byte hizalama
     size = (size + 3) & ~3;
 
+    spin_lock(&heap_lock);
     mem_block_t* current = heap_start;
 
     // First-fit algoritması
@@ -38,23 +122,103 @@ void* kmalloc(uint32_t size) {
             }
 
             current->is_free = 0;
-            used_memory += size + sizeof(mem_block_t);
 
+            // Bölünmeyen blokta istenenden fazlası verilir, gerçek boyutu say
+            used_memory += current->size + sizeof(mem_block_t);
+            if(used_memory > peak_memory)
+                peak_memory = used_memory;
+
+            alloc_count++;
+            size_histogram[size_bucket(size)]++;
+
+#if HEAP_TRACK_CALLERS
+            heap_site_t* site = find_site(caller);
+            site->live_bytes += current->size;
+            site->allocs++;
+            current->caller = caller;
+#else
+            (void)caller;
+#endif
+
+            spin_unlock(&heap_lock);
             return (void*)((uint8_t*)current + sizeof(mem_block_t));
         }
         current = current->next;
     }
 
+    failed_count++;
+    spin_unlock(&heap_lock);
     return NULL; // Bellek yetersiz
 }
 
+void* kmalloc(uint32_t size) {
+    return heap_alloc(size, (uint32_t)__builtin_return_address(0));
+}
+
+static int pool_index(void* ptr) {
+    uint32_t addr = (uint32_t)ptr;
+    if(addr < PAGE_POOL_START || addr >= PAGE_POOL_START + PAGE_POOL_PAGES * PAGE_SIZE)
+        return -1;
+    return (addr - PAGE_POOL_START) / PAGE_SIZE;
+}
+
+void* kzalloc(uint32_t size) {
+    uint32_t caller = (uint32_t)__builtin_return_address(0);
+
+    // Sayfaya yakın boyutlar önceden sıfırlanmış havuzdan gelir; sayaç,
+    // histogram ve çağrı noktası heap yoluyla aynı şekilde tutulur
+    if(size > PAGE_SIZE / 2 && size <= PAGE_SIZE) {
+        void* page = alloc_zeroed_page();
+        if(page != NULL) {
+            spin_lock(&heap_lock);
+            alloc_count++;
+            size_histogram[size_bucket(size)]++;
+#if HEAP_TRACK_CALLERS
+            heap_site_t* site = find_site(caller);
+            site->live_bytes += PAGE_SIZE;
+            site->allocs++;
+#endif
+            pool_page_caller[pool_index(page)] = caller;
+            spin_unlock(&heap_lock);
+            return page;
+        }
+    }
+
+    void* ptr = heap_alloc(size, caller);
+    if(ptr != NULL)
+        memset(ptr, 0, size);
+    return ptr;
+}
+
 void kfree(void* ptr) {
     if(ptr == NULL)
         return;
 
+    // kzalloc sayfa havuzundan verdiyse oraya geri dön
+    int index = pool_index(ptr);
+    if(index >= 0) {
+        spin_lock(&heap_lock);
+        if(pool_page_caller[index] != 0) {
+            free_count++;
+#if HEAP_TRACK_CALLERS
+            find_site(pool_page_caller[index])->live_bytes -= PAGE_SIZE;
+#endif
+            pool_page_caller[index] = 0;
+        }
+        spin_unlock(&heap_lock);
+        free_page(ptr);
+        return;
+    }
+
+    spin_lock(&heap_lock);
     mem_block_t* block = (mem_block_t*)((uint8_t*)ptr - sizeof(mem_block_t));
     block->is_free = 1;
     used_memory -= block->size + sizeof(mem_block_t);
+    free_count++;
+
+#if HEAP_TRACK_CALLERS
+    find_site(block->caller)->live_bytes -= block->size;
+#endif
 
     // Bitişik boş blokları birleştir
     mem_block_t* current = heap_start;
@@ -66,6 +230,7 @@ void kfree(void* ptr) {
             current = current->next;
         }
     }
+    spin_unlock(&heap_lock);
 }
 
 uint32_t get_total_memory() {
@@ -76,6 +241,143 @@ uint32_t get_used_memory() {
     return used_memory;
 }
 
+// Heap'i dolaşarak blok ve parçalanma istatistiklerini topla
+void get_heap_stats(heap_stats_t* stats) {
+    spin_lock(&heap_lock);
+    stats->total = total_memory;
+    stats->used = used_memory;
+    stats->peak = peak_memory;
+    stats->used_blocks = 0;
+    stats->free_blocks = 0;
+    stats->free_bytes = 0;
+    stats->largest_free = 0;
+    stats->alloc_count = alloc_count;
+    stats->free_count = free_count;
+    stats->failed_count = failed_count;
+
+    for(mem_block_t* b = heap_start; b != NULL; b = b->next) {
+        if(b->is_free) {
+            stats->free_blocks++;
+            stats->free_bytes += b->size;
+            if(b->size > stats->largest_free)
+                stats->largest_free = b->size;
+        } else {
+            stats->used_blocks++;
+        }
+    }
+
+    // Dış parçalanma: boş belleğin en büyük bloğun dışında kalan yüzdesi
+    if(stats->free_bytes > 0)
+        stats->fragmentation = 100 - stats->largest_free * 100 / stats->free_bytes;
+    else
+        stats->fragmentation = 0;
+
+    for(int i = 0; i < HEAP_HIST_BUCKETS; i++)
+        stats->histogram[i] = size_histogram[i];
+
+    spin_unlock(&heap_lock);
+
+    stats->free_pages = dirty_count + zeroed_count;
+    stats->zeroed_pages = zeroed_count;
+}
+
+// Sayfayı önbelleği kirletmeden sıfırla (SSE2 yoksa düz memset)
+static void zero_page_nt(uint32_t page) {
+    if(!has_sse2) {
+        memset((void*)page, 0, PAGE_SIZE);
+        return;
+    }
+
+    uint32_t p = page;
+    uint32_t n = PAGE_SIZE / 16;
+    asm volatile("1:\n"
+                 "movnti %%eax, (%0)\n"
+                 "movnti %%eax, 4(%0)\n"
+                 "movnti %%eax, 8(%0)\n"
+                 "movnti %%eax, 12(%0)\n"
+                 "add $16, %0\n"
+                 "dec %1\n"
+                 "jnz 1b\n"
+                 "sfence"
+                 : "+r"(p), "+r"(n)
+                 : "a"(0)
+                 : "memory");
+}
+
+void* alloc_page() {
+    void* page = NULL;
+
+    // Sıfırlı sayfaları sıfır isteyenlere sakla
+    spin_lock(&page_lock);
+    if(dirty_count > 0)
+        page = (void*)dirty_pages[--dirty_count];
+    else if(zeroed_count > 0)
+        page = (void*)zeroed_pages[--zeroed_count];
+    spin_unlock(&page_lock);
+    return page;
+}
+
+void* alloc_zeroed_page() {
+    uint32_t page = 0;
+    int need_zero = 0;
+
+    spin_lock(&page_lock);
+    if(zeroed_count > 0) {
+        if(zeroed_count <= ZERO_POOL_LOW)
+            zeroing_active = 1;
+        page = zeroed_pages[--zeroed_count];
+    } else if(dirty_count > 0) {
+        // Havuz boş: senkron sıfırla
+        page = dirty_pages[--dirty_count];
+        need_zero = 1;
+        zeroing_active = 1;
+    }
+    spin_unlock(&page_lock);
+
+    if(need_zero)
+        zero_page_nt(page);
+    return (void*)page;
+}
+
+void free_page(void* page) {
+    spin_lock(&page_lock);
+    dirty_pages[dirty_count++] = (uint32_t)page;
+    spin_unlock(&page_lock);
+}
+
+// Idle döngüsünden çağrılır: bir sayfa sıfırlar, iş yaptıysa 1 döner.
+// Havuz ZERO_POOL_HIGH'a dolunca durur, ZERO_POOL_LOW'un altına inince yeniden başlar.
+int zero_idle_page() {
+    spin_lock(&page_lock);
+    if(!zeroing_active || dirty_count == 0) {
+        spin_unlock(&page_lock);
+        return 0;
+    }
+
+    if(zeroed_count >= ZERO_POOL_HIGH) {
+        zeroing_active = 0;
+        spin_unlock(&page_lock);
+        return 0;
+    }
+
+    uint32_t page = dirty_pages[--dirty_count];
+    spin_unlock(&page_lock);
+
+    // Sıfırlama kilit dışında, diğer CPU'lar havuzu kullanmaya devam eder
+    zero_page_nt(page);
+
+    spin_lock(&page_lock);
+    zeroed_pages[zeroed_count++] = page;
+    spin_unlock(&page_lock);
+    return 1;
+}
+
+#if HEAP_TRACK_CALLERS
+const heap_site_t* get_heap_sites() {
+    return call_sites;
+}
+#endif
+
 void* memset(void* dest, int val, size_t len) {
     uint8_t* d = (uint8_t*)dest;
     while(len--) {
@@ -91,4 +393,4 @@ void* memcpy(void* dest, const void* src, size_t len) {
         *d++ = *s++;
     }
     return dest;
-}
\ No newline at end of file
+}
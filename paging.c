@@ -0,0 +1,226 @@
+// paging.c - Sayfalama: PSE büyük sayfalar, global kernel eşlemeleri, PAT
+#include "headers.h"
+
+// Sayfa dizini ve sayfa tablosu havuzu (4 KB hizalı olmak zorunda)
+static uint32_t page_directory[1024] __attribute__((aligned(4096)));
+static uint32_t page_tables[PAGING_MAX_TABLES][1024] __attribute__((aligned(4096)));
+static int tables_used = 0;
+
+static uint32_t global_flag = 0;    // PGE destekleniyorsa PAGE_GLOBAL
+static int pat_enabled = 0;
+
+// invlpg yalnızca yerel TLB'yi temizler ve TLB shootdown yok: AP'ler
+// açıldıktan sonra eşlemeler değiştirilemez (init_smp kilitler)
+static int mappings_locked = 0;
+
+static void invlpg(uint32_t addr) {
+    asm volatile("invlpg (%0)" : : "r"(addr) : "memory");
+}
+
+static uint32_t* alloc_page_table() {
+    if(tables_used >= PAGING_MAX_TABLES)
+        return NULL;
+
+    uint32_t* table = page_tables[tables_used++];
+    memset(table, 0, 4096);
+    return table;
+}
+
+// PAT girişi 4'ü write-combining yap; PTE'de yalnızca PAT biti seçer.
+// Varsayılan: WB, WT, UC-, UC, WB, WT, UC-, UC
+static void init_pat() {
+    uint64_t pat = rdmsr(MSR_IA32_PAT);
+    pat &= ~(0xFFULL << 32);
+    pat |= (uint64_t)PAT_TYPE_WC << 32;
+
+    asm volatile("wbinvd" : : : "memory");
+    wrmsr(MSR_IA32_PAT, pat);
+    asm volatile("wbinvd" : : : "memory");
+}
+
+// 4 MB'lık bir PSE sayfasını aynı özniteliklerle 1024 adet 4 KB sayfaya böl
+static uint32_t* split_large_page(uint32_t pd_index) {
+    uint32_t pde = page_directory[pd_index];
+    uint32_t* table = alloc_page_table();
+    if(table == NULL)
+        return NULL;
+
+    uint32_t base = pde & 0xFFC00000;
+    uint32_t flags = pde & (PAGE_PRESENT | PAGE_WRITE | PAGE_USER | PAGE_PWT | PAGE_PCD | PAGE_GLOBAL);
+    for(int i = 0; i < 1024; i++) {
+        table[i] = (base + i * PAGE_SIZE) | flags;
+    }
+
+    page_directory[pd_index] = (uint32_t)table | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+    // Tek invlpg, 4 MB'lık TLB girişini düşürür
+    invlpg(base);
+    return table;
+}
+
+// virt adresinin sayfa tablosunu döndür; gerekirse oluştur veya böl
+static uint32_t* get_page_table(uint32_t virt, int create) {
+    uint32_t pd_index = virt >> 22;
+    uint32_t pde = page_directory[pd_index];
+
+    if(pde & PAGE_PRESENT) {
+        if(pde & PAGE_LARGE)
+            return create ? split_large_page(pd_index) : NULL;
+        return (uint32_t*)(pde & 0xFFFFF000);
+    }
+
+    if(!create)
+        return NULL;
+
+    uint32_t* table = alloc_page_table();
+    if(table == NULL)
+        return NULL;
+
+    page_directory[pd_index] = (uint32_t)table | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+    return table;
+}
+
+void init_paging() {
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+
+    if(!(edx & CPUID_EDX_PSE)) {
+        kprint("Paging: CPU PSE desteklemiyor!\n");
+        return;
+    }
+    if(edx & CPUID_EDX_PGE)
+        global_flag = PAGE_GLOBAL;
+    if(edx & CPUID_EDX_PAT) {
+        init_pat();
+        pat_enabled = 1;
+    }
+
+    memset(page_directory, 0, sizeof(page_directory));
+    tables_used = 0;
+
+    // İlk 4 MB: VGA pencereleri ayrı önbellek tipi istediği için 4 KB sayfalar.
+    // Sayfa 0 boş bırakılır, NULL erişimleri page fault verir.
+    uint32_t* low = alloc_page_table();
+    for(uint32_t i = 1; i < 1024; i++) {
+        uint32_t addr = i * PAGE_SIZE;
+        uint32_t flags = PAGE_PRESENT | PAGE_WRITE | global_flag;
+        if(pat_enabled && addr >= VGA_WINDOW_START && addr < VGA_WINDOW_END)
+            flags |= PAGE_PAT;
+        low[i] = addr | flags;
+    }
+    // PDE user bitini açar; ring 3 erişimini PTE'lerdeki PAGE_USER belirler
+    page_directory[0] = (uint32_t)low | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+
+    // Geri kalan kernel alanı: 4 MB PSE sayfalar, global
+    for(uint32_t addr = LARGE_PAGE_SIZE; addr < PAGING_IDENTITY_END; addr += LARGE_PAGE_SIZE) {
+        page_directory[addr >> 22] = addr | PAGE_PRESENT | PAGE_WRITE | PAGE_LARGE | global_flag;
+    }
+
+    uint32_t cr4;
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= CR4_PSE;
+    asm volatile("mov %0, %%cr4" : : "r"(cr4));
+
+    asm volatile("mov %0, %%cr3" : : "r"(page_directory) : "memory");
+
+    uint32_t cr0;
+    asm volatile("mov %%cr0, %0" : "=r"(cr0));
+    cr0 |= CR0_PG;
+    asm volatile("mov %0, %%cr0" : : "r"(cr0) : "memory");
+
+    // PGE, sayfalama açıldıktan sonra etkinleştirilir
+    if(global_flag) {
+        cr4 |= CR4_PGE;
+        asm volatile("mov %0, %%cr4" : : "r"(cr4));
+    }
+}
+
+// AP'ler BSP'nin sayfa tablosuyla gelir; PAT MSR'ı ise CPU başınadır
+void init_paging_ap() {
+    if(pat_enabled)
+        init_pat();
+}
+
+void lock_mappings() {
+    mappings_locked = 1;
+}
+
+static int mappings_frozen(const char* who) {
+    if(!mappings_locked)
+        return 0;
+    kprint(who);
+    kprint(": AP'ler calisirken esleme degistirilemez\n");
+    return 1;
+}
+
+int map_page(uint32_t virt, uint32_t phys, uint32_t flags) {
+    if(mappings_frozen("map_page"))
+        return -1;
+
+    uint32_t* table = get_page_table(virt, 1);
+    if(table == NULL)
+        return -1;
+
+    table[(virt >> 12) & 0x3FF] = (phys & 0xFFFFF000) | (flags & 0xFFF) | PAGE_PRESENT;
+    invlpg(virt);
+    return 0;
+}
+
+void unmap_page(uint32_t virt) {
+    if(mappings_frozen("unmap_page"))
+        return;
+
+    // Büyük sayfanın içinden tek sayfa çıkarmak için önce bölünür
+    uint32_t* table = get_page_table(virt, page_directory[virt >> 22] & PAGE_LARGE);
+    if(table == NULL)
+        return;
+
+    table[(virt >> 12) & 0x3FF] = 0;
+    invlpg(virt);
+}
+
+uint32_t virt_to_phys(uint32_t virt) {
+    uint32_t pde = page_directory[virt >> 22];
+    if(!(pde & PAGE_PRESENT))
+        return 0;
+    if(pde & PAGE_LARGE)
+        return (pde & 0xFFC00000) | (virt & 0x3FFFFF);
+
+    uint32_t pte = ((uint32_t*)(pde & 0xFFFFF000))[(virt >> 12) & 0x3FF];
+    if(!(pte & PAGE_PRESENT))
+        return 0;
+    return (pte & 0xFFFFF000) | (virt & 0xFFF);
+}
+
+// [start, end) aralığını ring 3'e aç. Diğer CPU'ların TLB'sine yayılmadığı
+// için AP'ler başlamadan çağrılmalı.
+void set_user_access(uint32_t start, uint32_t end) {
+    if(mappings_frozen("set_user_access"))
+        return;
+
+    for(uint32_t addr = start & 0xFFFFF000; addr < end; addr += PAGE_SIZE) {
+        uint32_t* table = get_page_table(addr, 1);
+        if(table == NULL)
+            return;
+        table[(addr >> 12) & 0x3FF] |= PAGE_USER;
+        invlpg(addr);
+    }
+}
+
+// Sistem çağrısı argümanındaki tampon tamamen ring 3'e açık sayfalarda mı
+int user_access_ok(uint32_t addr, uint32_t len) {
+    if(addr + len < addr)
+        return 0;
+
+    uint32_t end = addr + len;
+    for(uint32_t page = addr & 0xFFFFF000; page < end; page += PAGE_SIZE) {
+        uint32_t pde = page_directory[page >> 22];
+        if(!(pde & PAGE_PRESENT) || !(pde & PAGE_USER) || (pde & PAGE_LARGE))
+            return 0;
+        uint32_t pte = ((uint32_t*)(pde & 0xFFFFF000))[(page >> 12) & 0x3FF];
+        if((pte & (PAGE_PRESENT | PAGE_USER)) != (PAGE_PRESENT | PAGE_USER))
+            return 0;
+        if(page + PAGE_SIZE < page)
+            break;
+    }
+    return 1;
+}
@@ -0,0 +1,49 @@
+// pci.c - PCI yapılandırma alanı erişimi (mekanizma #1, 0xCF8/0xCFC)
+#include "headers.h"
+
+static uint32_t pci_address(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset) {
+    return 0x80000000 | ((uint32_t)bus << 16) | ((uint32_t)slot << 11) |
+           ((uint32_t)func << 8) | (offset & 0xFC);
+}
+
+uint32_t pci_read32(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset) {
+    outl(PCI_CONFIG_ADDRESS, pci_address(bus, slot, func, offset));
+    return inl(PCI_CONFIG_DATA);
+}
+
+void pci_write32(uint8_t bus, uint8_t slot, uint8_t func, uint8_t offset, uint32_t val) {
+    outl(PCI_CONFIG_ADDRESS, pci_address(bus, slot, func, offset));
+    outl(PCI_CONFIG_DATA, val);
+}
+
+// Sınıf/alt sınıfa uyan ilk fonksiyonu bul
+int pci_find_class(uint8_t class_code, uint8_t subclass, pci_device_t* dev) {
+    for(int bus = 0; bus < 256; bus++) {
+        for(int slot = 0; slot < 32; slot++) {
+            for(int func = 0; func < 8; func++) {
+                uint32_t id = pci_read32(bus, slot, func, PCI_VENDOR_ID);
+                if((id & 0xFFFF) == 0xFFFF) {
+                    if(func == 0)
+                        break;
+                    continue;
+                }
+
+                uint32_t class_reg = pci_read32(bus, slot, func, PCI_CLASS);
+                if((class_reg >> 24) == class_code && ((class_reg >> 16) & 0xFF) == subclass) {
+                    dev->bus = bus;
+                    dev->slot = slot;
+                    dev->func = func;
+                    dev->vendor_id = id & 0xFFFF;
+                    dev->device_id = id >> 16;
+                    dev->prog_if = (class_reg >> 8) & 0xFF;
+                    return 0;
+                }
+
+                // Tek fonksiyonlu aygıtlarda diğer fonksiyonlara bakma
+                if(func == 0 && !(pci_read32(bus, slot, 0, PCI_HEADER_TYPE) & 0x800000))
+                    break;
+            }
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,127 @@
+// render.c - Karo paralel render hattı: worker task havuzu ve arka tampon
+#include "headers.h"
+
+static uint8_t* back_buffer = NULL;
+static int workers[RENDER_MAX_WORKERS];
+static int worker_count = 0;
+
+// Aktif kare; karo dağıtımı ve bariyer atomik sayaçlarla yapılır
+static render_tile_fn current_shader = NULL;
+static volatile uint32_t frame_active = 0;
+static volatile uint32_t next_tile = 0;
+static volatile uint32_t tiles_done = 0;
+static uint64_t frame_start = 0;
+
+// İstatistik
+static uint32_t frames_rendered = 0;
+static uint32_t last_frame_kcycles = 0;
+static uint32_t tiles_per_worker[RENDER_MAX_WORKERS];
+
+static void render_tile(uint32_t tile) {
+    int x0 = (tile % RENDER_TILES_X) * RENDER_TILE_W;
+    int y0 = (tile / RENDER_TILES_X) * RENDER_TILE_H;
+    current_shader(x0, y0, x0 + RENDER_TILE_W, y0 + RENDER_TILE_H, back_buffer);
+}
+
+// Bariyer: son karoyu bitiren worker kareyi VGA'ya kopyalar
+static void present_frame() {
+    uint32_t* src = (uint32_t*)back_buffer;
+    uint32_t* dst = (uint32_t*)0xA0000;
+    for(int i = 0; i < RENDER_WIDTH * RENDER_HEIGHT / 4; i++)
+        dst[i] = src[i];
+
+    last_frame_kcycles = (uint32_t)((rdtsc() - frame_start) >> 10);
+    frames_rendered++;
+    frame_active = 0;
+}
+
+// slot, create_task_arg ile verilen worker sırasıdır (tiles_per_worker indeksi)
+static void render_worker(uint32_t slot) {
+    while(1) {
+        uint32_t tile = frame_active ? atomic_add(&next_tile, 1) : RENDER_TILES;
+
+        if(tile < RENDER_TILES) {
+            render_tile(tile);
+            tiles_per_worker[slot]++;
+            if(atomic_add(&tiles_done, 1) + 1 == RENDER_TILES)
+                present_frame();
+            // Karolar arasında CPU'yu bırak, BSP'de kabuk tuşları işleyebilsin
+            yield();
+            continue;
+        }
+
+        // İş yok: uyu, render_submit uyandırır
+        task_prepare_block();
+        if(frame_active && next_tile < RENDER_TILES)
+            task_cancel_block();
+        else
+            schedule();
+    }
+}
+
+void init_render() {
+    back_buffer = kmalloc(RENDER_WIDTH * RENDER_HEIGHT);
+    if(back_buffer == NULL)
+        return;
+
+    // CPU başına bir worker, tek CPU'da bile en az iki
+    int count = get_cpu_count();
+    if(count < 2)
+        count = 2;
+    if(count > RENDER_MAX_WORKERS)
+        count = RENDER_MAX_WORKERS;
+
+    char name[] = "render0";
+    worker_count = 0;
+    for(int i = 0; i < count; i++) {
+        name[6] = '0' + i;
+        int id = create_task_arg(render_worker, name, 1, worker_count);
+        if(id < 0)
+            break;
+        workers[worker_count++] = id;
+    }
+}
+
+// Kareyi kuyruğa al ve hemen dön; sunum worker'larda yapılır
+int render_submit(render_tile_fn shader) {
+    if(back_buffer == NULL || worker_count == 0 || frame_active)
+        return -1;
+
+    current_shader = shader;
+    next_tile = 0;
+    tiles_done = 0;
+    frame_start = rdtsc();
+    frame_active = 1;
+
+    for(int i = 0; i < worker_count; i++)
+        task_wake(workers[i]);
+    return 0;
+}
+
+int render_busy() {
+    return frame_active;
+}
+
+void render_stats() {
+    kprint("Worker: ");
+    kprint_dec(worker_count);
+    kprint("  Karo: ");
+    kprint_dec(RENDER_TILES);
+    kprint(" (");
+    kprint_dec(RENDER_TILE_W);
+    kprint("x");
+    kprint_dec(RENDER_TILE_H);
+    kprint(")\n");
+    kprint("Kare: ");
+    kprint_dec(frames_rendered);
+    kprint("  Son kare: ");
+    kprint_dec(last_frame_kcycles);
+    kprint(" Kcycle\n");
+    for(int i = 0; i < worker_count; i++) {
+        kprint("  render");
+        kprint_dec(i);
+        kprint(": ");
+        kprint_dec(tiles_per_worker[i]);
+        kprint(" karo\n");
+    }
+}
@@ -5,6 +5,7 @@ static uint16_t* video_memory = (uint16_t*)VGA_MEMORY;
 static int cursor_x = 0;
 static int cursor_y = 0;
 static uint8_t current_color = 0x0F; // Beyaz üzerine siyah
+static spinlock_t screen_lock;
 
 void init_screen() {
     clear_screen();
@@ -48,6 +49,8 @@ void update_cursor() {
 }
 
 void kprint_char(char c) {
+    spin_lock(&screen_lock);
+
     if(c == '\n') {
         cursor_x = 0;
         cursor_y++;
@@ -75,6 +78,7 @@ void kprint_char(char c) {
     }
 
     update_cursor();
+    spin_unlock(&screen_lock);
 }
 
 void kprint(const char* str) {
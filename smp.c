@@ -0,0 +1,604 @@
+// smp.c - Çok işlemci desteği: MADT/MP ayrıştırma, LAPIC/IOAPIC, AP başlatma
+#include "headers.h"
+
+static cpu_t cpus[MAX_CPUS];
+static int cpu_count = 1;
+static uint8_t apic_to_cpu[256];
+
+static volatile uint32_t* lapic = NULL;
+static volatile uint32_t* ioapic = NULL;
+static uint32_t ioapic_gsi_base = 0;
+
+// ISA IRQ -> GSI eşlemesi ve MADT override bayrakları
+static uint32_t irq_gsi[16];
+static uint16_t irq_flags[16];
+
+#define STR(x) #x
+#define XSTR(x) STR(x)
+#define TRAMP(sym) XSTR(SMP_TRAMPOLINE) "+" #sym "-trampoline_start"
+
+// AP giriş kodu: SMP_TRAMPOLINE adresine kopyalanır, SIPI ile real mode'da
+// başlar, korumalı moda ve sayfalamaya geçip tramp_entry'yi çağırır
+asm(".text\n"
+    ".globl trampoline_start\n"
+    ".globl trampoline_end\n"
+    ".globl tramp_cr3\n"
+    ".globl tramp_cr4\n"
+    ".globl tramp_stack\n"
+    ".globl tramp_entry\n"
+    ".globl tramp_state\n"
+    ".code16\n"
+    "trampoline_start:\n"
+    " cli\n"
+    " mov %cs, %ax\n"
+    " mov %ax, %ds\n"
+    " lgdtl tramp_gdtr - trampoline_start\n"
+    " mov %cr0, %eax\n"
+    " and $0x9FFFFFFF, %eax\n"     // INIT sonrası CD/NW açık gelir, önbelleği aç
+    " or $1, %eax\n"
+    " mov %eax, %cr0\n"
+    " ljmpl $0x08, $" TRAMP(tramp_pm) "\n"
+    ".code32\n"
+    "tramp_pm:\n"
+    " mov $0x10, %ax\n"
+    " mov %ax, %ds\n"
+    " mov %ax, %es\n"
+    " mov %ax, %fs\n"
+    " mov %ax, %gs\n"
+    " mov %ax, %ss\n"
+    " mov " TRAMP(tramp_cr4) ", %eax\n"
+    " mov %eax, %cr4\n"
+    " mov " TRAMP(tramp_cr3) ", %eax\n"
+    " mov %eax, %cr3\n"
+    " mov %cr0, %eax\n"
+    " or $0x80000000, %eax\n"
+    " mov %eax, %cr0\n"
+    // Stack'e dokunmadan önce başlatmayı sahiplen; BSP zaman aşımında
+    // iptal ettiyse (2) stack serbest bırakılmış olabilir, dur
+    " xor %eax, %eax\n"
+    " mov $1, %ecx\n"
+    " lock cmpxchg %ecx, " TRAMP(tramp_state) "\n"
+    " jnz 1f\n"
+    " mov " TRAMP(tramp_stack) ", %esp\n"
+    " call *" TRAMP(tramp_entry) "\n"
+    "1:\n"
+    " cli\n"
+    " hlt\n"
+    " jmp 1b\n"
+    ".p2align 3\n"
+    "tramp_gdt:\n"
+    " .quad 0\n"
+    " .quad 0x00CF9A000000FFFF\n"
+    " .quad 0x00CF92000000FFFF\n"
+    "tramp_gdtr:\n"
+    " .word 23\n"
+    " .long " TRAMP(tramp_gdt) "\n"
+    "tramp_cr3: .long 0\n"
+    "tramp_cr4: .long 0\n"
+    "tramp_stack: .long 0\n"
+    "tramp_entry: .long 0\n"
+    "tramp_state: .long 0\n"         // 0 bekliyor, 1 AP sahiplendi, 2 iptal
+    "trampoline_end:\n");
+
+extern char trampoline_start[], trampoline_end[];
+extern char tramp_cr3[], tramp_cr4[], tramp_stack[], tramp_entry[], tramp_state[];
+
+#define TRAMP_WAITING 0
+#define TRAMP_CLAIMED 1
+#define TRAMP_CANCELLED 2
+
+// Kopyalanmış trampoline içindeki bir değişkenin adresi
+#define TRAMP_VAR(sym) ((volatile uint32_t*)(SMP_TRAMPOLINE + (sym - trampoline_start)))
+
+// ============================================
+// Kilitler
+// ============================================
+
+// Atomik topla, eski değeri döndür
+uint32_t atomic_add(volatile uint32_t* ptr, uint32_t val) {
+    asm volatile("lock xaddl %0, %1" : "+r"(val), "+m"(*ptr) : : "memory");
+    return val;
+}
+
+// Ticket lock: FIFO sıralı, CPU'lar arasında adil
+void spin_lock(spinlock_t* lock) {
+    uint32_t ticket = atomic_add(&lock->next, 1);
+    while(lock->owner != ticket) {
+        asm volatile("pause" : : : "memory");
+    }
+}
+
+void spin_unlock(spinlock_t* lock) {
+    asm volatile("" : : : "memory");
+    lock->owner = lock->owner + 1;
+}
+
+// Kesme işleyicisinden de alınan kilitler için (ör. IRQ'da task_wake)
+uint32_t spin_lock_irqsave(spinlock_t* lock) {
+    uint32_t flags;
+    asm volatile("pushf; pop %0; cli" : "=r"(flags) : : "memory");
+    spin_lock(lock);
+    return flags;
+}
+
+void spin_unlock_irqrestore(spinlock_t* lock, uint32_t flags) {
+    spin_unlock(lock);
+    asm volatile("push %0; popf" : : "r"(flags) : "memory", "cc");
+}
+
+void spin_init(spinlock_t* lock) {
+    lock->next = 0;
+    lock->owner = 0;
+}
+
+// ============================================
+// LAPIC / IOAPIC
+// ============================================
+
+static uint32_t lapic_read(uint32_t reg) {
+    return lapic[reg / 4];
+}
+
+static void lapic_write(uint32_t reg, uint32_t val) {
+    lapic[reg / 4] = val;
+    lapic_read(LAPIC_ID);   // Yazmanın tamamlanmasını bekle
+}
+
+static void lapic_enable() {
+    wrmsr(MSR_IA32_APIC_BASE, rdmsr(MSR_IA32_APIC_BASE) | APIC_BASE_ENABLE);
+    lapic_write(LAPIC_TPR, 0);
+    lapic_write(LAPIC_SVR, LAPIC_SVR_ENABLE | SPURIOUS_VECTOR);
+}
+
+void lapic_eoi() {
+    if(lapic != NULL)
+        lapic_write(LAPIC_EOI, 0);
+}
+
+static uint32_t ioapic_read(uint32_t reg) {
+    ioapic[0] = reg;
+    return ioapic[4];
+}
+
+static void ioapic_write(uint32_t reg, uint32_t val) {
+    ioapic[0] = reg;
+    ioapic[4] = val;
+}
+
+// ISA IRQ'yu BSP'ye, verilen vektörle yönlendir (MADT override'larına uyarak)
+void ioapic_route_irq(uint8_t irq, uint8_t vector) {
+    if(ioapic == NULL)
+        return;
+
+    uint32_t pin = irq_gsi[irq] - ioapic_gsi_base;
+    uint32_t low = vector;
+    if((irq_flags[irq] & 0x3) == 0x3)
+        low |= IOAPIC_ACTIVE_LOW;
+    if(((irq_flags[irq] >> 2) & 0x3) == 0x3)
+        low |= IOAPIC_LEVEL;
+
+    ioapic_write(IOAPIC_REDTBL + pin * 2 + 1, cpus[0].apic_id << 24);
+    ioapic_write(IOAPIC_REDTBL + pin * 2, low);
+}
+
+// ============================================
+// Tablo Ayrıştırma
+// ============================================
+
+typedef struct {
+    char signature[8];
+    uint8_t checksum;
+    char oem_id[6];
+    uint8_t revision;
+    uint32_t rsdt_address;
+} __attribute__((packed)) acpi_rsdp_t;
+
+typedef struct {
+    char signature[4];
+    uint32_t length;
+    uint8_t revision;
+    uint8_t checksum;
+    char oem_id[6];
+    char oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+} __attribute__((packed)) acpi_header_t;
+
+typedef struct {
+    char signature[4];
+    uint32_t config_table;
+    uint8_t length;
+    uint8_t spec_rev;
+    uint8_t checksum;
+    uint8_t features[5];
+} __attribute__((packed)) mp_floating_t;
+
+typedef struct {
+    char signature[4];
+    uint16_t base_length;
+    uint8_t spec_rev;
+    uint8_t checksum;
+    char oem_id[8];
+    char product_id[12];
+    uint32_t oem_table;
+    uint16_t oem_table_size;
+    uint16_t entry_count;
+    uint32_t lapic_address;
+    uint16_t ext_length;
+    uint8_t ext_checksum;
+    uint8_t reserved;
+} __attribute__((packed)) mp_config_t;
+
+static int sig_match(const char* a, const char* b, int len) {
+    for(int i = 0; i < len; i++) {
+        if(a[i] != b[i])
+            return 0;
+    }
+    return 1;
+}
+
+static uint8_t checksum(const uint8_t* p, uint32_t len) {
+    uint8_t sum = 0;
+    for(uint32_t i = 0; i < len; i++)
+        sum += p[i];
+    return sum;
+}
+
+// Identity map dışındaki fiziksel bir bölgeyi erişilebilir yap
+static void* phys_map(uint32_t phys, uint32_t len, uint32_t flags) {
+    for(uint32_t page = phys & ~0xFFF; page < phys + len; page += PAGE_SIZE) {
+        if(virt_to_phys(page) != page && map_page(page, page, flags) != 0)
+            return NULL;
+    }
+    return (void*)phys;
+}
+
+// İmzayı 16 byte sınırlarında ara. Sayfa 0 eşlenmediği için BDA'daki EBDA
+// işaretçisi okunmaz; taban belleğin son KB'ı ve BIOS ROM taranır.
+static void* scan_signature(const char* sig, int len) {
+    static const uint32_t ranges[2][2] = {
+        { 0x9FC00, 0xA0000 },
+        { 0xE0000, 0x100000 }
+    };
+
+    for(int r = 0; r < 2; r++) {
+        for(uint32_t addr = ranges[r][0]; addr < ranges[r][1]; addr += 16) {
+            if(sig_match((const char*)addr, sig, len))
+                return (void*)addr;
+        }
+    }
+    return NULL;
+}
+
+static void add_cpu(uint8_t apic_id) {
+    if(cpu_count >= MAX_CPUS)
+        return;
+    // BSP zaten cpus[0]
+    if(apic_id == cpus[0].apic_id)
+        return;
+
+    cpus[cpu_count].apic_id = apic_id;
+    apic_to_cpu[apic_id] = cpu_count;
+    cpu_count++;
+}
+
+static int parse_madt() {
+    acpi_rsdp_t* rsdp = scan_signature("RSD PTR ", 8);
+    if(rsdp == NULL || checksum((uint8_t*)rsdp, 20) != 0)
+        return 0;
+
+    acpi_header_t* rsdt = phys_map(rsdp->rsdt_address, sizeof(acpi_header_t), PAGE_WRITE);
+    if(rsdt == NULL || !phys_map(rsdp->rsdt_address, rsdt->length, PAGE_WRITE))
+        return 0;
+
+    uint32_t* entries = (uint32_t*)(rsdt + 1);
+    uint32_t entry_count = (rsdt->length - sizeof(acpi_header_t)) / 4;
+
+    for(uint32_t i = 0; i < entry_count; i++) {
+        acpi_header_t* table = phys_map(entries[i], sizeof(acpi_header_t), PAGE_WRITE);
+        if(table == NULL || !sig_match(table->signature, "APIC", 4))
+            continue;
+        if(!phys_map(entries[i], table->length, PAGE_WRITE))
+            return 0;
+
+        uint8_t* p = (uint8_t*)table + sizeof(acpi_header_t) + 8;
+        uint8_t* end = (uint8_t*)table + table->length;
+        while(p < end) {
+            switch(p[0]) {
+                case MADT_LAPIC:
+                    if(*(uint32_t*)(p + 4) & 1)
+                        add_cpu(p[3]);
+                    break;
+                case MADT_IOAPIC:
+                    if(ioapic == NULL) {
+                        ioapic = (volatile uint32_t*)*(uint32_t*)(p + 4);
+                        ioapic_gsi_base = *(uint32_t*)(p + 8);
+                    }
+                    break;
+                case MADT_ISO:
+                    if(p[3] < 16) {
+                        irq_gsi[p[3]] = *(uint32_t*)(p + 4);
+                        irq_flags[p[3]] = *(uint16_t*)(p + 8);
+                    }
+                    break;
+            }
+            p += p[1];
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static int parse_mp_table() {
+    mp_floating_t* mpf = scan_signature("_MP_", 4);
+    if(mpf == NULL || mpf->config_table == 0)
+        return 0;
+
+    mp_config_t* cfg = phys_map(mpf->config_table, sizeof(mp_config_t), PAGE_WRITE);
+    if(cfg == NULL || !sig_match(cfg->signature, "PCMP", 4))
+        return 0;
+    if(!phys_map(mpf->config_table, cfg->base_length, PAGE_WRITE))
+        return 0;
+
+    uint8_t* p = (uint8_t*)(cfg + 1);
+    for(int i = 0; i < cfg->entry_count; i++) {
+        if(p[0] == MP_PROCESSOR) {
+            if(p[3] & 1)
+                add_cpu(p[1]);
+            p += 20;
+        } else {
+            if(p[0] == MP_IOAPIC && ioapic == NULL && (p[3] & 1))
+                ioapic = (volatile uint32_t*)*(uint32_t*)(p + 4);
+            p += 8;
+        }
+    }
+    return 1;
+}
+
+// ============================================
+// AP Başlatma
+// ============================================
+
+static void send_ipi(uint8_t apic_id, uint32_t command) {
+    lapic_write(LAPIC_ICR_HIGH, (uint32_t)apic_id << 24);
+    lapic_write(LAPIC_ICR_LOW, command);
+    while(lapic_read(LAPIC_ICR_LOW) & LAPIC_ICR_PENDING) {
+        asm volatile("pause");
+    }
+}
+
+static uint32_t cmpxchg(volatile uint32_t* ptr, uint32_t old, uint32_t val) {
+    uint32_t prev;
+    asm volatile("lock cmpxchg %2, %1"
+                 : "=a"(prev), "+m"(*ptr)
+                 : "r"(val), "0"(old)
+                 : "memory");
+    return prev;
+}
+
+// Store -> load sıralaması: idle bayrağı ile kuyruk sayacı arasında
+static void full_barrier() {
+    asm volatile("lock orl $0, (%%esp)" : : : "memory", "cc");
+}
+
+static void wakeup_ipi(regs_t* regs) {
+    (void)regs;
+    lapic_eoi();
+}
+
+static void ap_main() {
+    asm volatile("fninit");
+    load_gdt();
+    load_idt();
+    init_paging_ap();
+    lapic_enable();
+
+    // Ring 3 geçişleri için CPU'ya özel TSS ve SYSENTER MSR'ları
+    load_tss(this_cpu()->id);
+    init_sysenter();
+
+    this_cpu()->online = 1;
+
+    // Idle döngüsü: kendi kuyruğu boşsa schedule() başkasından çalar,
+    // o da boşsa sıfır sayfa havuzunu doldurur, sonra IPI gelene kadar uyur
+    while(1) {
+        schedule();
+        if(!zero_idle_page())
+            cpu_idle();
+    }
+}
+
+static int start_ap(cpu_t* cpu) {
+    uint32_t stack = (uint32_t)kmalloc(AP_STACK_SIZE);
+    if(stack == 0)
+        return 0;
+
+    *TRAMP_VAR(tramp_stack) = stack + AP_STACK_SIZE;
+    *TRAMP_VAR(tramp_state) = TRAMP_WAITING;
+    *TRAMP_VAR(tramp_entry) = (uint32_t)ap_main;
+
+    // INIT-SIPI-SIPI
+    send_ipi(cpu->apic_id, LAPIC_ICR_INIT);
+    pit_delay_us(10000);
+    for(int i = 0; i < 2; i++) {
+        send_ipi(cpu->apic_id, LAPIC_ICR_STARTUP | (SMP_TRAMPOLINE >> 12));
+        pit_delay_us(200);
+    }
+
+    for(int i = 0; i < 100 && !cpu->online; i++)
+        pit_delay_us(1000);
+    if(cpu->online)
+        return 1;
+
+    // Trampoline'a henüz girmediyse iptal et; geç gelirse stack'e dokunmadan durur
+    if(cmpxchg(TRAMP_VAR(tramp_state), TRAMP_WAITING, TRAMP_CANCELLED) == TRAMP_WAITING) {
+        kfree((void*)stack);
+        return 0;
+    }
+
+    // AP stack'i aldı, yalnızca yavaş: biraz daha bekle, gelmezse stack'i sızdır
+    for(int i = 0; i < 1000 && !cpu->online; i++)
+        pit_delay_us(1000);
+    return cpu->online ? 1 : 0;
+}
+
+// ============================================
+// Genel API
+// ============================================
+
+// Kuyruklarda iş yoksa uyu. cli altında idle işaretlenip kontrol edilir,
+// sti'nin tek komutluk gecikmesi arada gelen IPI'nın hlt'yi kaçırmasını önler.
+void cpu_idle() {
+    cpu_t* self = this_cpu();
+
+    asm volatile("cli");
+    self->idle = 1;
+    full_barrier();
+
+    int work = 0;
+    for(int i = 0; i < cpu_count; i++) {
+        if(cpus[i].rq_count > 0)
+            work = 1;
+    }
+
+    if(work)
+        asm volatile("sti");
+    else
+        asm volatile("sti; hlt");
+    self->idle = 0;
+}
+
+// rq_push sonrası: hedef CPU uyuyorsa onu, değilse çalabilecek başka bir
+// uyuyan CPU'yu uyandır
+void smp_kick_idle(cpu_t* target) {
+    if(lapic == NULL)
+        return;
+
+    full_barrier();
+    cpu_t* self = this_cpu();
+    cpu_t* victim = NULL;
+    if(target != self && target->idle) {
+        victim = target;
+    } else {
+        for(int i = 0; i < cpu_count; i++) {
+            if(&cpus[i] != self && cpus[i].idle) {
+                victim = &cpus[i];
+                break;
+            }
+        }
+    }
+    if(victim == NULL)
+        return;
+
+    // ICR yazımı yarıda kesilip bir IRQ'nun IPI'ıyla karışmasın
+    uint32_t flags;
+    asm volatile("pushf; pop %0; cli" : "=r"(flags) : : "memory");
+    victim->idle = 0;
+    send_ipi(victim->apic_id, LAPIC_ICR_FIXED | WAKEUP_VECTOR);
+    asm volatile("push %0; popf" : : "r"(flags) : "memory", "cc");
+}
+
+cpu_t* this_cpu() {
+    if(lapic == NULL)
+        return &cpus[0];
+    return &cpus[apic_to_cpu[lapic_read(LAPIC_ID) >> 24]];
+}
+
+cpu_t* get_cpu(int index) {
+    return &cpus[index];
+}
+
+int get_cpu_count() {
+    return cpu_count;
+}
+
+void init_smp() {
+    for(int i = 0; i < MAX_CPUS; i++) {
+        cpus[i].id = i;
+        cpus[i].online = 0;
+    }
+    for(int i = 0; i < 16; i++) {
+        irq_gsi[i] = i;
+        irq_flags[i] = 0;
+    }
+    cpu_count = 1;
+    cpus[0].online = 1;
+
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+    if(!(edx & CPUID_EDX_APIC))
+        return;
+
+    uint32_t lapic_phys = (uint32_t)rdmsr(MSR_IA32_APIC_BASE) & 0xFFFFF000;
+    cpus[0].apic_id = ebx >> 24;
+    apic_to_cpu[cpus[0].apic_id] = 0;
+
+    if(!parse_madt() && !parse_mp_table())
+        return;
+
+    if(phys_map(lapic_phys, PAGE_SIZE, PAGE_WRITE | PAGE_PCD | PAGE_PWT) == NULL)
+        return;
+    lapic = (volatile uint32_t*)lapic_phys;
+    lapic_enable();
+
+    if(ioapic != NULL) {
+        if(phys_map((uint32_t)ioapic, PAGE_SIZE, PAGE_WRITE | PAGE_PCD | PAGE_PWT) == NULL) {
+            ioapic = NULL;
+        } else {
+            // Tüm girişleri maskele, açık IRQ'lar switch_to_ioapic ile yönlenir
+            uint32_t max_entry = (ioapic_read(IOAPIC_VER) >> 16) & 0xFF;
+            for(uint32_t i = 0; i <= max_entry; i++)
+                ioapic_write(IOAPIC_REDTBL + i * 2, IOAPIC_MASKED);
+            switch_to_ioapic();
+        }
+    }
+
+    // AP'ler BSP ile aynı sayfa tablosunu kullanır; bundan sonra map_page
+    // yalnızca yerel TLB'yi temizleyeceği için eşlemeler kilitlenir
+    lock_mappings();
+
+    // Trampoline'ı düşük belleğe kopyala
+    memcpy((void*)SMP_TRAMPOLINE, trampoline_start, trampoline_end - trampoline_start);
+    uint32_t cr3, cr4;
+    asm volatile("mov %%cr3, %0" : "=r"(cr3));
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    *TRAMP_VAR(tramp_cr3) = cr3;
+    *TRAMP_VAR(tramp_cr4) = cr4;
+
+    register_interrupt_handler(WAKEUP_VECTOR, wakeup_ipi);
+
+    // Başlamayan CPU'dan sonrası denenmez: geç kalan bir AP trampoline
+    // durumunu sıfırlanmış görüp sonraki AP'nin stack'ini alabilir
+    int found = cpu_count;
+    cpu_count = 1;
+    for(int i = 1; i < found; i++) {
+        cpu_t* cpu = &cpus[cpu_count];
+        cpu->apic_id = cpus[i].apic_id;
+        apic_to_cpu[cpu->apic_id] = cpu_count;
+        if(!start_ap(cpu))
+            break;
+        cpu_count++;
+    }
+}
+
+void list_cpus() {
+    kprint("CPU APIC Kuyruk Gecis     Calma\n");
+    kprint("--- ---- ------ --------- --------\n");
+    for(int i = 0; i < cpu_count; i++) {
+        kprint_dec(i);
+        kprint("   ");
+        kprint_dec(cpus[i].apic_id);
+        kprint("    ");
+        kprint_dec(cpus[i].rq_count);
+        kprint("      ");
+        kprint_dec(cpus[i].switches);
+        kprint("  ");
+        kprint_dec(cpus[i].steals);
+        kprint("\n");
+    }
+    if(ioapic != NULL)
+        kprint("Kesme denetleyicisi: LAPIC/IOAPIC\n");
+    else
+        kprint("Kesme denetleyicisi: 8259 PIC\n");
+}
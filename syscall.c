@@ -0,0 +1,261 @@
+// syscall.c - Sistem çağrı tablosu, int 0x80 ve SYSENTER/SYSEXIT girişleri
+#include "headers.h"
+
+typedef uint32_t (*syscall_fn_t)(uint32_t a, uint32_t b, uint32_t c);
+
+typedef struct {
+    const char* name;
+    syscall_fn_t fn;
+} syscall_entry_t;
+
+// CPU başına sayaçlar: sıcak yolda kilit ve atomik işlem yok
+typedef struct {
+    uint32_t calls;
+    uint32_t fast_calls;        // SYSENTER üzerinden gelenler
+    uint64_t cycles;            // Kernel içinde geçen TSC
+} syscall_stat_t;
+
+static syscall_stat_t stats[MAX_CPUS][SYSCALL_COUNT];
+static uint32_t bad_calls = 0;
+static int sysenter_ok = 0;
+
+extern char __user_start[], __user_end[];
+
+// User stack'leri .user bölümünün sonundadır, açılışta ring 3'e açılır
+static uint8_t user_stacks[USER_MAX_TASKS][USER_STACK_SIZE]
+    __attribute__((section(".user.stack"), aligned(4096)));
+static uint32_t user_stack_used = 0;
+static spinlock_t user_stack_lock;
+
+// ============================================
+// Çağrılar
+// ============================================
+static uint32_t sys_exit(uint32_t code, uint32_t b, uint32_t c) {
+    (void)code; (void)b; (void)c;
+    task_exit();
+    return 0;
+}
+
+static uint32_t sys_write(uint32_t buf, uint32_t len, uint32_t c) {
+    (void)c;
+    if(!user_access_ok(buf, len))
+        return (uint32_t)-1;
+
+    const char* str = (const char*)buf;
+    for(uint32_t i = 0; i < len; i++)
+        kprint_char(str[i]);
+    return len;
+}
+
+static uint32_t sys_yield(uint32_t a, uint32_t b, uint32_t c) {
+    (void)a; (void)b; (void)c;
+    yield();
+    return 0;
+}
+
+static uint32_t sys_gettid(uint32_t a, uint32_t b, uint32_t c) {
+    (void)a; (void)b; (void)c;
+    return get_current_task()->id;
+}
+
+static uint32_t sys_nop(uint32_t a, uint32_t b, uint32_t c) {
+    (void)a; (void)b; (void)c;
+    return 0;
+}
+
+static const syscall_entry_t syscall_table[SYSCALL_COUNT] = {
+    [SYS_EXIT]   = { "exit",   sys_exit },
+    [SYS_WRITE]  = { "write",  sys_write },
+    [SYS_YIELD]  = { "yield",  sys_yield },
+    [SYS_GETTID] = { "gettid", sys_gettid },
+    [SYS_NOP]    = { "nop",    sys_nop },
+};
+
+// ============================================
+// Dağıtım
+// ============================================
+
+// Yüklü TSS seçicisi CPU'yu verir; LAPIC ID okumasından çok daha ucuz
+static int current_cpu_index() {
+    uint16_t sel;
+    asm volatile("str %0" : "=r"(sel));
+    return (sel >> 3) - GDT_TSS_BASE;
+}
+
+static void syscall_dispatch(regs_t* regs, int fast) {
+    uint32_t nr = regs->eax;
+    if(nr >= SYSCALL_COUNT) {
+        atomic_add(&bad_calls, 1);
+        regs->eax = (uint32_t)-1;
+        return;
+    }
+
+    // exit/yield başka CPU'da dönebilir; sayaç giriş CPU'suna yazılır
+    syscall_stat_t* st = &stats[current_cpu_index()][nr];
+    st->calls++;
+    if(fast)
+        st->fast_calls++;
+
+    uint64_t start = rdtsc();
+    regs->eax = syscall_table[nr].fn(regs->ebx, regs->esi, regs->edi);
+    st->cycles += rdtsc() - start;
+}
+
+static void syscall_int80(regs_t* regs) {
+    syscall_dispatch(regs, 0);
+}
+
+void sysenter_dispatch(regs_t* regs) {
+    syscall_dispatch(regs, 1);
+}
+
+// SYSENTER: esp = MSR değeri = &tss.esp0, ecx = user esp, edx = dönüş eip.
+// int 0x80 ile aynı regs_t çerçevesi kurulur; SYSEXIT ecx/edx'ten döner.
+// sti'nin tek komutluk gecikmesi kesmenin sysexit'ten önce gelmesini önler.
+asm(".text\n"
+    ".globl sysenter_entry\n"
+    "sysenter_entry:\n"
+    " mov (%esp), %esp\n"
+    " push $0x23\n"                 // ss (USER_DS | 3)
+    " push %ecx\n"                  // useresp
+    " pushf\n"
+    " push $0x1B\n"                 // cs (USER_CS | 3)
+    " push %edx\n"                  // eip
+    " push $0\n"
+    " push $0x80\n"
+    " pusha\n"
+    " push %ds\n"
+    " push %es\n"
+    " push %fs\n"
+    " push %gs\n"
+    " mov $0x10, %ax\n"
+    " mov %ax, %ds\n"
+    " mov %ax, %es\n"
+    " push %esp\n"
+    " call sysenter_dispatch\n"
+    " add $4, %esp\n"
+    " pop %gs\n"
+    " pop %fs\n"
+    " pop %es\n"
+    " pop %ds\n"
+    " popa\n"
+    " add $8, %esp\n"
+    " pop %edx\n"
+    " add $4, %esp\n"
+    " popf\n"
+    " pop %ecx\n"
+    " sti\n"
+    " sysexit\n");
+
+extern void sysenter_entry();
+
+// Ring 3'e ilk iniş: iret çerçevesi user ss:esp, eflags (IF açık), cs:eip
+void enter_user(uint32_t eip, uint32_t esp) {
+    asm volatile("mov %0, %%ds\n"
+                 "mov %0, %%es\n"
+                 "mov %0, %%fs\n"
+                 "mov %0, %%gs\n"
+                 "push %0\n"
+                 "push %1\n"
+                 "push $0x202\n"
+                 "push %2\n"
+                 "push %3\n"
+                 "iret\n"
+                 : : "r"(USER_DS | 3), "r"(esp), "i"(USER_CS | 3), "r"(eip) : "memory");
+}
+
+// ============================================
+// Kurulum
+// ============================================
+
+// CPU başına: MSR'lar ve TSS her çekirdekte ayrıdır (AP'ler de çağırır)
+void init_sysenter() {
+    if(!sysenter_ok)
+        return;
+
+    int cpu = this_cpu()->id;
+    wrmsr(MSR_IA32_SYSENTER_CS, KERNEL_CS);
+    wrmsr(MSR_IA32_SYSENTER_ESP, (uint32_t)tss_esp0_ptr(cpu));
+    wrmsr(MSR_IA32_SYSENTER_EIP, (uint32_t)sysenter_entry);
+}
+
+void init_syscalls() {
+    spin_init(&user_stack_lock);
+    memset(stats, 0, sizeof(stats));
+
+    // AP'ler başlamadan: PTE değişikliği başka TLB'lere yayılmaz
+    set_user_access((uint32_t)__user_start, (uint32_t)__user_end);
+
+    load_tss(0);
+    register_interrupt_handler(SYSCALL_VECTOR, syscall_int80);
+
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+    sysenter_ok = (edx & CPUID_EDX_SEP) && (edx & CPUID_EDX_MSR);
+    user_use_sysenter = sysenter_ok;
+    init_sysenter();
+}
+
+int sysenter_enabled() {
+    return sysenter_ok;
+}
+
+uint32_t user_stack_alloc() {
+    uint32_t stack = 0;
+    spin_lock(&user_stack_lock);
+    for(int i = 0; i < USER_MAX_TASKS; i++) {
+        if(!(user_stack_used & (1u << i))) {
+            user_stack_used |= 1u << i;
+            stack = (uint32_t)user_stacks[i];
+            break;
+        }
+    }
+    spin_unlock(&user_stack_lock);
+    return stack;
+}
+
+void user_stack_free(uint32_t stack) {
+    int i = (stack - (uint32_t)user_stacks) / USER_STACK_SIZE;
+    spin_lock(&user_stack_lock);
+    user_stack_used &= ~(1u << i);
+    spin_unlock(&user_stack_lock);
+}
+
+// 64-bit bölme yok: ortalama için toplamı 32 bit'e sığana kadar kaydır
+static uint32_t average(uint64_t total, uint32_t count) {
+    while((total >> 32) && count > 1) {
+        total >>= 1;
+        count >>= 1;
+    }
+    return count ? (uint32_t)total / count : 0;
+}
+
+void list_syscalls() {
+    kprint("No Ad      Cagri      SYSENTER   Ort. cycle\n");
+    kprint("-- ------- ---------- ---------- ----------\n");
+    for(int nr = 0; nr < SYSCALL_COUNT; nr++) {
+        uint32_t calls = 0, fast = 0;
+        uint64_t cycles = 0;
+        for(int cpu = 0; cpu < MAX_CPUS; cpu++) {
+            calls += stats[cpu][nr].calls;
+            fast += stats[cpu][nr].fast_calls;
+            cycles += stats[cpu][nr].cycles;
+        }
+
+        kprint_dec(nr);
+        kprint("  ");
+        kprint(syscall_table[nr].name);
+        for(int j = strlen(syscall_table[nr].name); j < 8; j++)
+            kprint(" ");
+        kprint_dec(calls);
+        kprint("  ");
+        kprint_dec(fast);
+        kprint("  ");
+        kprint_dec(average(cycles, calls));
+        kprint("\n");
+    }
+    kprint("Gecersiz: ");
+    kprint_dec(bad_calls);
+    kprint(", hizli yol: ");
+    kprint(sysenter_ok ? "SYSENTER\n" : "yok (int 0x80)\n");
+}
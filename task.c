@@ -1,29 +1,188 @@
-// task.c - Basit cooperative multitasking scheduler
+// task.c - Cooperative multitasking scheduler (CPU başına run queue, iş çalma)
 #include "headers.h"
 
 static task_t tasks[MAX_TASKS];
 static int task_count = 0;
-static int current_task_id = -1;
+static spinlock_t task_lock;
+
+// Context switch: callee-saved register'ları eski stack'e it, esp'yi kaydet,
+// yeni stack'e geç ve onun register'larını geri al
+asm(".text\n"
+    ".globl switch_context\n"
+    "switch_context:\n"
+    " push %ebp\n"
+    " push %ebx\n"
+    " push %esi\n"
+    " push %edi\n"
+    " mov 20(%esp), %eax\n"
+    " mov %esp, (%eax)\n"
+    " mov 24(%esp), %esp\n"
+    " pop %edi\n"
+    " pop %esi\n"
+    " pop %ebx\n"
+    " pop %ebp\n"
+    " ret\n");
+
+extern void switch_context(uint32_t* old_esp, uint32_t new_esp);
+
+static void rq_push(cpu_t* cpu, int task_id) {
+    uint32_t irq = spin_lock_irqsave(&cpu->rq_lock);
+    cpu->run_queue[(cpu->rq_head + cpu->rq_count) % MAX_TASKS] = task_id;
+    cpu->rq_count++;
+    spin_unlock_irqrestore(&cpu->rq_lock, irq);
+    smp_kick_idle(cpu);
+}
+
+// Sahibi kuyruğun başından alır
+static int rq_pop(cpu_t* cpu) {
+    int task_id = -1;
+    uint32_t irq = spin_lock_irqsave(&cpu->rq_lock);
+    if(cpu->rq_count > 0) {
+        task_id = cpu->run_queue[cpu->rq_head];
+        cpu->rq_head = (cpu->rq_head + 1) % MAX_TASKS;
+        cpu->rq_count--;
+    }
+    spin_unlock_irqrestore(&cpu->rq_lock, irq);
+    return task_id;
+}
+
+// Çalan CPU kuyruğun sonundan alır, sahibiyle çakışma azalır
+static int rq_steal(cpu_t* cpu) {
+    int task_id = -1;
+    uint32_t irq = spin_lock_irqsave(&cpu->rq_lock);
+    if(cpu->rq_count > 0) {
+        cpu->rq_count--;
+        task_id = cpu->run_queue[(cpu->rq_head + cpu->rq_count) % MAX_TASKS];
+    }
+    spin_unlock_irqrestore(&cpu->rq_lock, irq);
+    return task_id;
+}
+
+// En kalabalık kuyruktan bir task çal
+static int steal_task(cpu_t* self) {
+    cpu_t* busiest = NULL;
+    int max_count = 0;
+
+    for(int i = 0; i < get_cpu_count(); i++) {
+        cpu_t* cpu = get_cpu(i);
+        if(cpu != self && cpu->rq_count > max_count) {
+            busiest = cpu;
+            max_count = cpu->rq_count;
+        }
+    }
+
+    if(busiest == NULL)
+        return -1;
+
+    int task_id = rq_steal(busiest);
+    if(task_id >= 0)
+        self->steals++;
+    return task_id;
+}
+
+// Switch sonrası yeni context'te çalışır: bırakılan task artık kimsenin
+// stack'inde değildir, kuyruğa geri konabilir veya stack'i serbest bırakılabilir
+static void finish_task_switch() {
+    cpu_t* cpu = this_cpu();
+    int prev = cpu->prev_task;
+    cpu->prev_task = -1;
+
+    if(prev < 0)
+        return;
+
+    uint32_t irq = spin_lock_irqsave(&task_lock);
+    tasks[prev].on_cpu = 0;
+    task_state_t state = tasks[prev].state;
+    if(state == TASK_READY)
+        rq_push(cpu, prev);
+    spin_unlock_irqrestore(&task_lock, irq);
+
+    // Kernel stack en son bırakılır: stack == 0, slotun yeniden kullanılabilir olduğunu gösterir
+    if(state == TASK_TERMINATED && tasks[prev].user_stack != 0) {
+        user_stack_free(tasks[prev].user_stack);
+        tasks[prev].user_stack = 0;
+    }
+    if(state == TASK_TERMINATED && tasks[prev].stack != 0) {
+        kfree((void*)tasks[prev].stack);
+        tasks[prev].stack = 0;
+    }
+}
+
+// Yeni task'ların ilk çalıştığı yer
+static void task_trampoline() {
+    finish_task_switch();
+
+    // User task'ı ring 3'e iret ile iner, geri dönmez
+    task_t* task = get_current_task();
+    if(task->user_eip)
+        enter_user(task->user_eip, task->user_stack + USER_STACK_SIZE);
+
+    asm volatile("sti");
+    void (*entry)(uint32_t) = (void (*)(uint32_t))task->eip;
+    entry(task->arg);
+    task_exit();
+}
 
 void init_scheduler() {
     for(int i = 0; i < MAX_TASKS; i++) {
         tasks[i].state = TASK_TERMINATED;
+        tasks[i].stack = 0;
+        tasks[i].user_stack = 0;
+        tasks[i].on_cpu = 0;
     }
     task_count = 0;
-    current_task_id = -1;
+    spin_init(&task_lock);
+
+    for(int i = 0; i < MAX_CPUS; i++) {
+        cpu_t* cpu = get_cpu(i);
+        spin_init(&cpu->rq_lock);
+        cpu->rq_head = 0;
+        cpu->rq_count = 0;
+        cpu->current_task = -1;
+        cpu->prev_task = -1;
+        cpu->switches = 0;
+        cpu->steals = 0;
+    }
 }
 
-void create_task(void (*entry)(), const char* name, uint32_t priority) {
-    if(task_count >= MAX_TASKS) {
+static int spawn_task(void (*entry)(), const char* name, uint32_t priority, uint32_t arg,
+                      uint32_t user_eip, uint32_t user_stack) {
+    // Bitmiş, hiçbir CPU'da olmayan ve stack'leri bırakılmış ilk slotu al.
+    // Hazırlanırken on_cpu = 1 slotu ayırır; state TERMINATED kaldığı için
+    // eski id'ye gelen task_wake() onu kuyruğa koymaz.
+    uint32_t irq = spin_lock_irqsave(&task_lock);
+    int task_id = -1;
+    for(int i = 0; i < MAX_TASKS; i++) {
+        if(tasks[i].state == TASK_TERMINATED && !tasks[i].on_cpu &&
+           tasks[i].stack == 0 && tasks[i].user_stack == 0) {
+            task_id = i;
+            break;
+        }
+    }
+    if(task_id < 0) {
+        spin_unlock_irqrestore(&task_lock, irq);
         kprint("Task limit reached!\n");
-        return;
+        return -1;
+    }
+    tasks[task_id].on_cpu = 1;
+    if(task_id >= task_count)
+        task_count = task_id + 1;
+    spin_unlock_irqrestore(&task_lock, irq);
+
+    uint32_t stack = (uint32_t)kmalloc(TASK_STACK_SIZE);
+    if(stack == 0) {
+        tasks[task_id].on_cpu = 0;
+        kprint("Task stack ayrilamadi!\n");
+        return -1;
     }
 
-    int task_id = task_count++;
     tasks[task_id].id = task_id;
-    tasks[task_id].state = TASK_READY;
     tasks[task_id].priority = priority;
     tasks[task_id].eip = (uint32_t)entry;
+    tasks[task_id].stack = stack;
+    tasks[task_id].user_eip = user_eip;
+    tasks[task_id].user_stack = user_stack;
+    tasks[task_id].arg = arg;
 
     // İsmi kopyala
     int i;
@@ -32,49 +191,192 @@ void create_task(void (*entry)(), const char* name, uint32_t priority) {
     }
     tasks[task_id].name[i] = '\0';
 
-    // Stack ayarla (basit implementasyon)
-    uint32_t stack = (uint32_t)kmalloc(4096);
-    tasks[task_id].esp = stack + 4096;
-    tasks[task_id].ebp = tasks[task_id].esp;
+    // İlk switch_context, sıfır register'ları alıp task_trampoline'a döner
+    uint32_t* sp = (uint32_t*)(stack + TASK_STACK_SIZE);
+    *--sp = 0;                          // task_trampoline dönüş adresi (kullanılmaz)
+    *--sp = (uint32_t)task_trampoline;
+    *--sp = 0;                          // ebp
+    *--sp = 0;                          // ebx
+    *--sp = 0;                          // esi
+    *--sp = 0;                          // edi
+    tasks[task_id].esp = (uint32_t)sp;
+    tasks[task_id].ebp = stack + TASK_STACK_SIZE;
+
+    // Oluşturan CPU'nun kuyruğuna koy, boştaki CPU'lar çalarak dağıtır
+    cpu_t* cpu = this_cpu();
+    tasks[task_id].cpu = cpu->id;
+    irq = spin_lock_irqsave(&task_lock);
+    tasks[task_id].state = TASK_READY;
+    tasks[task_id].on_cpu = 0;
+    spin_unlock_irqrestore(&task_lock, irq);
+    rq_push(cpu, task_id);
+    return task_id;
+}
+
+int create_task(void (*entry)(), const char* name, uint32_t priority) {
+    return spawn_task(entry, name, priority, 0, 0, 0);
+}
+
+// arg, task kuyruğa girmeden yazılır; hangi CPU'da başlarsa başlasın görür
+int create_task_arg(void (*entry)(uint32_t), const char* name, uint32_t priority, uint32_t arg) {
+    return spawn_task((void (*)())entry, name, priority, arg, 0, 0);
+}
+
+// entry .user bölümünde olmalı (USER_TEXT); kernel stack'i kesme ve
+// sistem çağrıları için kalır
+int create_user_task(void (*entry)(), const char* name) {
+    uint32_t user_stack = user_stack_alloc();
+    if(user_stack == 0) {
+        kprint("User stack kalmadi!\n");
+        return -1;
+    }
+
+    int task_id = spawn_task(NULL, name, 1, 0, (uint32_t)entry, user_stack);
+    if(task_id < 0)
+        user_stack_free(user_stack);
+    return task_id;
 }
 
 void schedule() {
-    // Basit round-robin scheduler
-    if(task_count == 0)
-        return;
+    uint32_t flags;
+    asm volatile("pushf; pop %0; cli" : "=r"(flags) : : "memory");
+
+    cpu_t* cpu = this_cpu();
+    int prev = cpu->current_task;
+    int next = -1;
 
-    int next_task = (current_task_id + 1) % task_count;
+    // Task'lar her zaman CPU'nun idle context'ine döner, sıradakini o seçer.
+    // BSP'de idle context kabuktur; böylece meşgul task'lar kabuğu aç bırakmaz.
+    if(prev < 0) {
+        next = rq_pop(cpu);
+        if(next < 0)
+            next = steal_task(cpu);
 
-    // Ready durumda bir task bul
-    int attempts = 0;
-    while(tasks[next_task].state != TASK_READY && attempts < task_count) {
-        next_task = (next_task + 1) % task_count;
-        attempts++;
+        // Idle context'teyiz ve iş yok
+        if(next < 0) {
+            asm volatile("push %0; popf" : : "r"(flags) : "memory", "cc");
+            return;
+        }
     }
 
-    if(tasks[next_task].state == TASK_READY) {
-        // Mevcut task'ı kaydet
-        if(current_task_id >= 0 && tasks[current_task_id].state == TASK_RUNNING) {
-            tasks[current_task_id].state = TASK_READY;
+    if(prev >= 0 && tasks[prev].state == TASK_RUNNING)
+        tasks[prev].state = TASK_READY;
+
+    cpu->prev_task = prev;
+    cpu->current_task = next;
+    if(next >= 0) {
+        tasks[next].state = TASK_RUNNING;
+        tasks[next].on_cpu = 1;
+        tasks[next].cpu = cpu->id;
+        if(tasks[next].user_eip)
+            tss_set_kernel_stack(cpu->id, tasks[next].stack + TASK_STACK_SIZE);
+    }
+    cpu->switches++;
+
+    switch_context(prev >= 0 ? &tasks[prev].esp : &cpu->idle_esp,
+                   next >= 0 ? tasks[next].esp : cpu->idle_esp);
+
+    // Buraya başka bir CPU'da dönülmüş olabilir
+    finish_task_switch();
+    asm volatile("push %0; popf" : : "r"(flags) : "memory", "cc");
+}
+
+// Uyumadan önce çağrılır: task BLOCKED işaretlenir, ardından çağıran
+// koşulunu yeniden kontrol edip ya task_cancel_block() ya da schedule() çağırır.
+// Arada gelen task_wake() kaybolmaz, task'ı READY yapar.
+void task_prepare_block() {
+    task_t* task = get_current_task();
+    uint32_t irq = spin_lock_irqsave(&task_lock);
+    task->state = TASK_BLOCKED;
+    spin_unlock_irqrestore(&task_lock, irq);
+}
+
+void task_cancel_block() {
+    task_t* task = get_current_task();
+    uint32_t irq = spin_lock_irqsave(&task_lock);
+    task->state = TASK_RUNNING;
+    spin_unlock_irqrestore(&task_lock, irq);
+}
+
+void task_wake(int task_id) {
+    uint32_t irq = spin_lock_irqsave(&task_lock);
+    if(tasks[task_id].state == TASK_BLOCKED) {
+        tasks[task_id].state = TASK_READY;
+        // Hâlâ bir CPU'dan çıkıyorsa finish_task_switch kuyruğa koyar
+        if(!tasks[task_id].on_cpu)
+            rq_push(get_cpu(tasks[task_id].cpu), task_id);
+    }
+    spin_unlock_irqrestore(&task_lock, irq);
+}
+
+void mutex_init(mutex_t* m) {
+    spin_init(&m->lock);
+    m->locked = 0;
+    m->waiters = 0;
+}
+
+// Task, bekleyen bit'i yayımlanmadan önce BLOCKED olur: mutex_unlock bit'i
+// gördüğü anda task_wake() onu mutlaka READY yapar, uyandırma kaybolmaz
+void mutex_lock(mutex_t* m) {
+    task_t* task = get_current_task();
+
+    while(1) {
+        if(task != NULL)
+            task_prepare_block();
+
+        spin_lock(&m->lock);
+        if(!m->locked) {
+            m->locked = 1;
+            spin_unlock(&m->lock);
+            if(task != NULL)
+                task_cancel_block();
+            return;
         }
 
-        // Yeni task'a geç
-        current_task_id = next_task;
-        tasks[current_task_id].state = TASK_RUNNING;
+        // Idle context uyuyamaz: sahibi kuyruktaysa çalışsın diye schedule()
+        if(task == NULL) {
+            spin_unlock(&m->lock);
+            schedule();
+            asm volatile("pause");
+            continue;
+        }
 
-        // Context switch yap (basitleştirilmiş)
-        // Gerçek implementasyonda register'ları kaydetmek gerekir
+        m->waiters |= 1u << task->id;
+        spin_unlock(&m->lock);
+        schedule();
     }
 }
 
+void mutex_unlock(mutex_t* m) {
+    spin_lock(&m->lock);
+    m->locked = 0;
+    uint32_t waiters = m->waiters;
+    m->waiters = 0;
+    spin_unlock(&m->lock);
+
+    // Hepsi uyanır ve yeniden dener
+    for(int i = 0; waiters != 0; i++, waiters >>= 1) {
+        if(waiters & 1)
+            task_wake(i);
+    }
+}
+
+task_state_t get_task_state(int task_id) {
+    return tasks[task_id].state;
+}
+
+int tasks_pending() {
+    return this_cpu()->rq_count > 0;
+}
+
 void list_tasks() {
     if(task_count == 0) {
         kprint("Hic task yok.\n");
         return;
     }
 
-    kprint("ID  Name                State      Priority\n");
-    kprint("--- ------------------- ---------- --------\n");
+    kprint("ID  Name                State      Priority CPU\n");
+    kprint("--- ------------------- ---------- -------- ---\n");
 
     for(int i = 0; i < task_count; i++) {
         // ID
@@ -105,11 +407,16 @@ void list_tasks() {
 
         // Priority
         kprint_dec(tasks[i].priority);
+        kprint("        ");
+
+        // CPU
+        kprint_dec(tasks[i].cpu);
         kprint("\n");
     }
 }
 
 task_t* get_current_task() {
+    int current_task_id = this_cpu()->current_task;
     if(current_task_id >= 0 && current_task_id < task_count) {
         return &tasks[current_task_id];
     }
@@ -121,9 +428,10 @@ void yield() {
 }
 
 void task_exit() {
-    if(current_task_id >= 0) {
-        tasks[current_task_id].state = TASK_TERMINATED;
-        kfree((void*)(tasks[current_task_id].esp - 4096));
+    task_t* task = get_current_task();
+    if(task != NULL) {
+        // Stack, başka bir context'e geçildikten sonra finish_task_switch'te bırakılır
+        task->state = TASK_TERMINATED;
     }
     schedule();
-}
\ No newline at end of file
+}
@@ -0,0 +1,76 @@
+// user.c - Ring 3 programları (.user bölümü, yalnızca kendi kod/verisine erişir)
+#include "headers.h"
+
+// Kernel koduna çağrı yapılamaz: buradaki her fonksiyon USER_TEXT olmalı,
+// sabitler de .rodata yerine USER_DATA dizilerinde durur
+
+#define USER_BENCH_ITERATIONS 10000
+
+uint32_t user_use_sysenter USER_DATA = 0;
+user_bench_t user_bench_result USER_DATA = { 0, 0, 0, 0 };
+
+static char bench_msg[] USER_DATA = "[user] sistem cagrisi testi bitti\n";
+static char crash_msg[] USER_DATA = "[user] kernel bellegine yaziliyor...\n";
+
+USER_TEXT static uint32_t user_rdtsc() {
+    uint32_t lo, hi;
+    asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return lo;
+}
+
+USER_TEXT static uint32_t syscall_int80(uint32_t nr, uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t ret;
+    asm volatile("int $0x80" : "=a"(ret) : "a"(nr), "b"(a), "S"(b), "D"(c) : "memory");
+    return ret;
+}
+
+// SYSEXIT dönüşü için user esp ecx'te, dönüş adresi edx'te verilir
+USER_TEXT static uint32_t syscall_fast(uint32_t nr, uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t ret;
+    asm volatile("mov %%esp, %%ecx\n"
+                 "lea 1f, %%edx\n"
+                 "sysenter\n"
+                 "1:\n"
+                 : "=a"(ret) : "a"(nr), "b"(a), "S"(b), "D"(c) : "ecx", "edx", "memory");
+    return ret;
+}
+
+USER_TEXT static uint32_t syscall(uint32_t nr, uint32_t a, uint32_t b, uint32_t c) {
+    if(user_use_sysenter)
+        return syscall_fast(nr, a, b, c);
+    return syscall_int80(nr, a, b, c);
+}
+
+USER_TEXT static uint32_t user_strlen(const char* str) {
+    uint32_t len = 0;
+    while(str[len])
+        len++;
+    return len;
+}
+
+// Boş çağrının gidiş-dönüş süresi, iki giriş yolu için ayrı ayrı
+USER_TEXT void user_bench_main() {
+    uint32_t start = user_rdtsc();
+    for(uint32_t i = 0; i < USER_BENCH_ITERATIONS; i++)
+        syscall_int80(SYS_NOP, 0, 0, 0);
+    user_bench_result.int80_cycles = (user_rdtsc() - start) / USER_BENCH_ITERATIONS;
+
+    if(user_use_sysenter) {
+        start = user_rdtsc();
+        for(uint32_t i = 0; i < USER_BENCH_ITERATIONS; i++)
+            syscall_fast(SYS_NOP, 0, 0, 0);
+        user_bench_result.sysenter_cycles = (user_rdtsc() - start) / USER_BENCH_ITERATIONS;
+    }
+
+    user_bench_result.iterations = USER_BENCH_ITERATIONS;
+    syscall(SYS_WRITE, (uint32_t)bench_msg, user_strlen(bench_msg), 0);
+    user_bench_result.done = 1;
+    syscall(SYS_EXIT, 0, 0, 0);
+}
+
+// Kernel heap'i supervisor sayfada: yazma page fault verir, yalnızca bu task ölür
+USER_TEXT void user_crash_main() {
+    syscall(SYS_WRITE, (uint32_t)crash_msg, user_strlen(crash_msg), 0);
+    *(volatile uint32_t*)HEAP_START = 0xDEADBEEF;
+    syscall(SYS_EXIT, 0, 0, 0);
+}
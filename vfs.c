@@ -0,0 +1,189 @@
+// vfs.c - initrd (cpio newc) üzerinde salt okunur bellek içi dosya sistemi
+#include "headers.h"
+
+// Arşiv kernel imajının hemen arkasına, sektör hizalı olarak yüklenir
+extern char __image_end[];
+
+static vfs_node_t nodes[VFS_MAX_FILES];
+static int node_count = 0;
+static int hash_buckets[VFS_HASH_SIZE];
+
+static vfs_file_t open_files[VFS_MAX_OPEN];
+static spinlock_t vfs_lock;
+
+static const uint8_t* initrd_base = NULL;
+static uint32_t initrd_size = 0;
+
+// FNV-1a; baştaki '/' yok sayılır, "/motd.txt" ile "motd.txt" aynı dosyadır
+static uint32_t path_hash(const char* path) {
+    uint32_t hash = 2166136261u;
+    while(*path) {
+        hash ^= (uint8_t)*path++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static const char* skip_slash(const char* path) {
+    while(*path == '/')
+        path++;
+    return path;
+}
+
+static uint32_t parse_hex(const char* p) {
+    uint32_t val = 0;
+    for(int i = 0; i < 8; i++) {
+        char c = p[i];
+        val <<= 4;
+        if(c >= '0' && c <= '9')
+            val |= c - '0';
+        else if(c >= 'a' && c <= 'f')
+            val |= c - 'a' + 10;
+        else if(c >= 'A' && c <= 'F')
+            val |= c - 'A' + 10;
+    }
+    return val;
+}
+
+static int find_node(const char* path) {
+    path = skip_slash(path);
+    uint32_t hash = path_hash(path);
+
+    for(int i = hash_buckets[hash % VFS_HASH_SIZE]; i >= 0; i = nodes[i].next) {
+        if(nodes[i].hash == hash && strcmp(nodes[i].name, path) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void add_node(const char* name, const uint8_t* data, uint32_t size, uint32_t mode) {
+    if(node_count >= VFS_MAX_FILES)
+        return;
+
+    vfs_node_t* node = &nodes[node_count];
+    node->name = skip_slash(name);
+    node->data = data;
+    node->size = size;
+    node->mode = mode;
+    node->hash = path_hash(node->name);
+
+    uint32_t bucket = node->hash % VFS_HASH_SIZE;
+    node->next = hash_buckets[bucket];
+    hash_buckets[bucket] = node_count;
+    node_count++;
+}
+
+// newc başlığı: "070701" + 13 adet 8 haneli hex alan, toplam 110 byte.
+// İsim ve veri 4 byte'a hizalıdır; veri arşivin içinde yerinde kalır.
+static void parse_cpio(const uint8_t* base, uint32_t limit) {
+    uint32_t offset = 0;
+
+    while(offset + CPIO_HEADER_SIZE <= limit) {
+        const char* hdr = (const char*)(base + offset);
+        if(hdr[0] != '0' || hdr[1] != '7' || hdr[2] != '0' ||
+           hdr[3] != '7' || hdr[4] != '0' || hdr[5] != '1')
+            break;
+
+        uint32_t mode = parse_hex(hdr + 14);
+        uint32_t filesize = parse_hex(hdr + 54);
+        uint32_t namesize = parse_hex(hdr + 94);
+        const char* name = hdr + CPIO_HEADER_SIZE;
+
+        if(strcmp(name, "TRAILER!!!") == 0) {
+            offset += CPIO_HEADER_SIZE + namesize;
+            break;
+        }
+
+        uint32_t data_offset = (offset + CPIO_HEADER_SIZE + namesize + 3) & ~3;
+        if((mode & CPIO_MODE_TYPE) == CPIO_MODE_FILE)
+            add_node(name, base + data_offset, filesize, mode);
+
+        offset = (data_offset + filesize + 3) & ~3;
+    }
+
+    initrd_size = offset;
+}
+
+void init_vfs() {
+    node_count = 0;
+    for(int i = 0; i < VFS_HASH_SIZE; i++)
+        hash_buckets[i] = -1;
+    for(int i = 0; i < VFS_MAX_OPEN; i++)
+        open_files[i].node = NULL;
+    spin_init(&vfs_lock);
+
+    initrd_base = (const uint8_t*)(((uint32_t)__image_end + 511) & ~511);
+    parse_cpio(initrd_base, INITRD_MAX_SIZE);
+}
+
+int vfs_open(const char* path) {
+    int index = find_node(path);
+    if(index < 0)
+        return -1;
+
+    spin_lock(&vfs_lock);
+    for(int fd = 0; fd < VFS_MAX_OPEN; fd++) {
+        if(open_files[fd].node == NULL) {
+            open_files[fd].node = &nodes[index];
+            open_files[fd].offset = 0;
+            spin_unlock(&vfs_lock);
+            return fd;
+        }
+    }
+    spin_unlock(&vfs_lock);
+    return -1;
+}
+
+void vfs_close(int fd) {
+    if(fd >= 0 && fd < VFS_MAX_OPEN)
+        open_files[fd].node = NULL;
+}
+
+int vfs_read(int fd, void* buf, uint32_t len) {
+    if(fd < 0 || fd >= VFS_MAX_OPEN || open_files[fd].node == NULL)
+        return -1;
+
+    vfs_file_t* file = &open_files[fd];
+    uint32_t left = file->node->size - file->offset;
+    if(len > left)
+        len = left;
+
+    memcpy(buf, file->node->data + file->offset, len);
+    file->offset += len;
+    return len;
+}
+
+// Kopyasız erişim: arşivin içindeki veriye doğrudan işaretçi
+const void* vfs_map(int fd, uint32_t* size) {
+    if(fd < 0 || fd >= VFS_MAX_OPEN || open_files[fd].node == NULL)
+        return NULL;
+
+    if(size != NULL)
+        *size = open_files[fd].node->size;
+    return open_files[fd].node->data;
+}
+
+int vfs_stat(const char* path, vfs_stat_t* st) {
+    int index = find_node(path);
+    if(index < 0)
+        return -1;
+
+    st->size = nodes[index].size;
+    st->mode = nodes[index].mode;
+    return 0;
+}
+
+// index'inci dosyanın adı ve bilgisi; liste bitince -1
+int vfs_readdir(int index, const char** name, vfs_stat_t* st) {
+    if(index < 0 || index >= node_count)
+        return -1;
+
+    *name = nodes[index].name;
+    st->size = nodes[index].size;
+    st->mode = nodes[index].mode;
+    return 0;
+}
+
+uint32_t vfs_initrd_size() {
+    return initrd_size;
+}